@@ -0,0 +1,156 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "sandpile.h"
+#include "stencil.h"
+#include "sandpile_group.h"
+
+using namespace std;
+
+// Шаблоны начальных куч
+enum Pattern { CENTER = 0, UNIFORM = 1, SPIKES = 2 };
+
+vector<vector<uint64_t>> make_grid(int n, int pattern) {
+    vector<vector<uint64_t>> grid(n, vector<uint64_t>(n, 0));
+    mt19937_64 rng(42);
+    if (pattern == CENTER) {
+        grid[n / 2][n / 2] = uint64_t(n) * n;
+    } else if (pattern == UNIFORM) {
+        uniform_int_distribution<uint64_t> d(0, 7);
+        for (auto& row : grid) {
+            for (auto& c : row) c = d(rng);
+        }
+    } else {
+        uniform_int_distribution<int> pos(0, n - 1);
+        for (int i = 0; i < n * n / 1000 + 1; ++i) grid[pos(rng)][pos(rng)] = 10000;
+    }
+    return grid;
+}
+
+// update() меняет сетку на месте, а начальные кучи быстро стабилизируются,
+// поэтому каждая итерация начинается с несчитаемой копии исходной сетки
+static void BM_Update(benchmark::State& state) {
+    int n = state.range(0);
+    const auto start = make_grid(n, state.range(1));
+    auto grid = start;
+    for (auto _ : state) {
+        state.PauseTiming();
+        grid = start;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(update(grid));
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(n) * n);
+    state.SetLabel(state.range(1) == CENTER ? "center" : state.range(1) == UNIFORM ? "uniform" : "spikes");
+}
+BENCHMARK(BM_Update)
+    ->ArgsProduct({benchmark::CreateRange(256, 16384, 4), {CENTER, UNIFORM, SPIKES}})
+    ->ArgNames({"n", "pattern"})
+    ->Unit(benchmark::kMillisecond);
+
+template <class S>
+static void BM_UpdateStencil(benchmark::State& state) {
+    int n = state.range(0);
+    const auto start = make_grid(n, UNIFORM);
+    auto grid = start;
+    for (auto _ : state) {
+        state.PauseTiming();
+        grid = start;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(update<S>(grid));
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(n) * n);
+}
+BENCHMARK_TEMPLATE(BM_UpdateStencil, Moore)->RangeMultiplier(4)->Range(256, 4096)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_UpdateStencil, Hex)->RangeMultiplier(4)->Range(256, 4096)->Unit(benchmark::kMillisecond);
+
+static void BM_UpdateCubic(benchmark::State& state) {
+    int n = state.range(0);
+    const Volume start(n, make_grid(n, UNIFORM));
+    Volume vol = start;
+    for (auto _ : state) {
+        state.PauseTiming();
+        vol = start;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(update<Cubic>(vol));
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(n) * n * n);
+}
+BENCHMARK(BM_UpdateCubic)->RangeMultiplier(2)->Range(32, 256)->Unit(benchmark::kMillisecond);
+
+static void BM_UpdateStats(benchmark::State& state) {
+    int n = state.range(0);
+    const auto start = make_grid(n, UNIFORM);
+    auto grid = start;
+    for (auto _ : state) {
+        state.PauseTiming();
+        grid = start;
+        state.ResumeTiming();
+        IterStats st;
+        benchmark::DoNotOptimize(update(grid, st));
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(n) * n);
+}
+BENCHMARK(BM_UpdateStats)->RangeMultiplier(4)->Range(256, 4096)->Unit(benchmark::kMillisecond);
+
+static void BM_ReadInput(benchmark::State& state) {
+    int lines = state.range(0);
+    int n = 4096;
+    string path = (filesystem::temp_directory_path() / "sandpile_bench.tsv").string();
+    {
+        ofstream out(path);
+        mt19937 rng(7);
+        uniform_int_distribution<int> pos(0, n - 1);
+        for (int i = 0; i < lines; ++i) out << pos(rng) << '\t' << pos(rng) << '\t' << 1000 << '\n';
+    }
+    int64_t bytes = filesystem::file_size(path);
+    vector<vector<uint64_t>> grid(n, vector<uint64_t>(n, 0));
+    for (auto _ : state) {
+        read_input(path, grid);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.SetItemsProcessed(state.iterations() * int64_t(lines));
+    filesystem::remove(path);
+}
+BENCHMARK(BM_ReadInput)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_WriteImage(benchmark::State& state) {
+    int n = state.range(0);
+    auto grid = make_grid(n, UNIFORM);
+    string path = (filesystem::temp_directory_path() / "sandpile_bench.bmp").string();
+    for (auto _ : state) {
+        write_image(path, grid);
+    }
+    state.SetBytesProcessed(state.iterations() * int64_t(filesystem::file_size(path)));
+    state.SetItemsProcessed(state.iterations() * int64_t(n) * n);
+    filesystem::remove(path);
+}
+BENCHMARK(BM_WriteImage)->RangeMultiplier(4)->Range(256, 16384)->Unit(benchmark::kMillisecond);
+
+static void BM_WritePyramid(benchmark::State& state) {
+    int n = state.range(0);
+    auto grid = make_grid(n, UNIFORM);
+    string base = (filesystem::temp_directory_path() / "sandpile_bench_pyr").string();
+    for (auto _ : state) {
+        write_pyramid(base, grid, 4, 4);
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(n) * n);
+    filesystem::remove(base + ".bmp");
+    for (int k = 1; k <= 4; ++k) filesystem::remove(base + "_lvl" + to_string(k) + ".bmp");
+}
+BENCHMARK(BM_WritePyramid)->RangeMultiplier(4)->Range(256, 16384)->Unit(benchmark::kMillisecond);
+
+static void BM_Identity(benchmark::State& state) {
+    int n = state.range(0);
+    for (auto _ : state) {
+        Sandpile e = Sandpile::compute_identity(n, n);
+        benchmark::DoNotOptimize(e.cells().data());
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(n) * n);
+}
+BENCHMARK(BM_Identity)->RangeMultiplier(2)->Range(32, 256)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -1,10 +1,11 @@
 #include <iostream>
 #include <fstream>
-#include <sstream>
-#include <vector>
-#include <cstdint>
 #include <filesystem>
 #include <unordered_map>
+#include <chrono>
+
+#include "sandpile.h"
+#include "stencil.h"
 
 using namespace std;
 
@@ -15,34 +16,11 @@ struct Params {
     string out_folder;
     uint64_t max_steps = 0;
     uint64_t save_freq = 0;
-};
-
-#pragma pack(push, 1)
-struct BMP {
-    uint16_t type = 0x4D42;
-    uint32_t size;
-    uint32_t reserved = 0;
-    uint32_t offset = 54;
-    uint32_t header_size = 40;
-    int32_t width;
-    int32_t height;
-    uint16_t planes = 1;
-    uint16_t bpp = 24;
-    uint32_t compression = 0;
-    uint32_t img_size = 0;
-    int32_t x_res = 1000;
-    int32_t y_res = 1000;
-    uint32_t used = 0;
-    uint32_t important = 0;
-};
-#pragma pack(pop)
-
-uint8_t palette[5][3] = {
-    {255, 255, 255},
-    {0, 255, 0},
-    {128, 0, 128},
-    {255, 255, 0},
-    {0, 0, 0}
+    uint32_t scale = 1;
+    uint32_t levels = 0;
+    string trace_file;
+    string lattice = "vonneumann";
+    uint16_t d = 1;
 };
 
 Params extract_args(int argc, char* argv[]) {
@@ -64,109 +42,178 @@ Params extract_args(int argc, char* argv[]) {
     if (a.count("--max-iter")) p.max_steps = stoull(a["--max-iter"]);
     if (a.count("-f")) p.save_freq = stoull(a["-f"]);
     if (a.count("--freq")) p.save_freq = stoull(a["--freq"]);
+    if (a.count("-s")) p.scale = stoul(a["-s"]);
+    if (a.count("--scale")) p.scale = stoul(a["--scale"]);
+    if (a.count("-p")) p.levels = stoul(a["-p"]);
+    if (a.count("--pyramid")) p.levels = stoul(a["--pyramid"]);
+    if (a.count("-t")) p.trace_file = a["-t"];
+    if (a.count("--trace")) p.trace_file = a["--trace"];
+    if (a.count("-n")) p.lattice = a["-n"];
+    if (a.count("--lattice")) p.lattice = a["--lattice"];
+    if (a.count("-d")) p.d = stoi(a["-d"]);
+    if (a.count("--depth")) p.d = stoi(a["--depth"]);
+    if (p.scale == 0) p.scale = 1;
+    if (p.d == 0) p.d = 1;
 
     return p;
 }
 
-void read_input(const string& path, vector<vector<uint64_t>>& field) {
-    ifstream in(path);
-    string ln;
-    while (getline(in, ln)) {
-        istringstream s(ln);
-        int x, y;
-        uint64_t c;
-        s >> x;
-        s.ignore();
-        s >> y;
-        s.ignore();
-        s >> c;
-        if (y < field.size() && x < field[0].size()) {
-            field[y][x] += c;
-        }
-    }
+bool save_state(const string& base, const Grid& data, const Params& p, uint64_t threshold) {
+    bool ok = p.scale > 1 || p.levels > 0
+        ? write_pyramid(base, data, p.scale, p.levels, threshold)
+        : write_image(base + ".bmp", data, threshold);
+    if (!ok) cerr << "Cannot write image: " << base << endl;
+    return ok;
 }
 
-void write_image(const string& fname, const vector<vector<uint64_t>>& data) {
-    int h = data.size();
-    int w = data[0].size();
-    int row_bytes = (w * 3 + 3) & ~3;
-    int total_size = 54 + row_bytes * h;
-
-    BMP bmp;
-    bmp.size = total_size;
-    bmp.width = w;
-    bmp.height = h;
-    bmp.img_size = row_bytes * h;
-
-    ofstream out(fname, ios::binary);
-    out.write(reinterpret_cast<char*>(&bmp), sizeof(bmp));
-
-    vector<uint8_t> row(row_bytes);
-
-    for (int y = h - 1; y >= 0; --y) {
-        fill(row.begin(), row.end(), 0);
-        for (int x = 0; x < w; ++x) {
-            int v = data[y][x] > 3 ? 4 : static_cast<int>(data[y][x]);
-            row[x * 3 + 0] = palette[v][2];
-            row[x * 3 + 1] = palette[v][1];
-            row[x * 3 + 2] = palette[v][0];
-        }
-        out.write(reinterpret_cast<char*>(row.data()), row_bytes);
+// Для объёма сохраняется центральный срез
+bool save_state(const string& base, const Volume& data, const Params& p, uint64_t threshold) {
+    return save_state(base, data[data.size() / 2], p, threshold);
+}
+
+// Трассировка: CSV или Chrome trace JSON (chrome://tracing, Perfetto) по расширению файла
+struct Trace;
+bool trace_close(Trace& tr);
+
+struct Trace {
+    ofstream out;
+    bool json = false;
+    bool first = true;
+    chrono::steady_clock::time_point start;
+
+    // Файл закрывается на любом пути выхода из run(), поэтому JSON всегда завершён
+    ~Trace() {
+        if (out.is_open()) trace_close(*this);
     }
+};
+
+double trace_now(const Trace& tr) {
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - tr.start).count();
 }
 
-bool update(vector<vector<uint64_t>>& mat) {
-    int h = mat.size();
-    int w = mat[0].size();
-    auto tmp = mat;
-    bool active = false;
-
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            if (mat[y][x] >= 4) {
-                uint64_t drop = mat[y][x] / 4;
-                tmp[y][x] -= drop * 4;
-                if (y > 0) tmp[y - 1][x] += drop;
-                if (y + 1 < h) tmp[y + 1][x] += drop;
-                if (x > 0) tmp[y][x - 1] += drop;
-                if (x + 1 < w) tmp[y][x + 1] += drop;
-                active = true;
-            }
-        }
+// Возвращает false, если файл трассировки не открылся
+bool trace_open(Trace& tr, const string& path) {
+    tr.out.open(path);
+    if (!tr.out) return false;
+    tr.json = filesystem::path(path).extension() == ".json";
+    tr.start = chrono::steady_clock::now();
+    if (tr.json) {
+        tr.out << "{\"traceEvents\":[";
+    } else {
+        tr.out << "iteration,toppled,lost,x0,y0,x1,y1,max_height,update_us,write_us\n";
     }
+    return true;
+}
 
-    mat = tmp;
-    return active;
+void trace_event(Trace& tr, const char* name, double ts, double dur, uint64_t iter) {
+    tr.out << (tr.first ? "\n" : ",\n");
+    tr.first = false;
+    tr.out << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << ts
+           << ",\"dur\":" << dur << ",\"args\":{\"iteration\":" << iter << "}}";
 }
 
-int main(int argc, char* argv[]) {
-    if (argc < 9) {
-        cout << "Usage: ./sandpiles -l <height> -w <width> -i <input.tsv> -o <output_dir> -m <max_iter> -f <freq>\n";
-        return 1;
+void trace_write(Trace& tr, const IterStats& st) {
+    if (!tr.json) {
+        tr.out << st.iter << ',' << st.toppled << ',' << st.lost << ','
+               << st.x0 << ',' << st.y0 << ',' << st.x1 << ',' << st.y1 << ','
+               << st.max_height << ',' << st.update_us << ',' << st.write_us << '\n';
+        return;
     }
+    if (st.write_us > 0) trace_event(tr, "write_image", st.write_start, st.write_us, st.iter);
+    trace_event(tr, "update", st.update_start, st.update_us, st.iter);
+    tr.out << ",\n{\"name\":\"pile\",\"ph\":\"C\",\"pid\":1,\"ts\":" << st.update_start
+           << ",\"args\":{\"toppled\":" << st.toppled << ",\"lost\":" << st.lost
+           << ",\"max_height\":" << st.max_height << "}}";
+    tr.out << ",\n{\"name\":\"active_box\",\"ph\":\"C\",\"pid\":1,\"ts\":" << st.update_start
+           << ",\"args\":{\"width\":" << (st.x1 - st.x0 + 1) << ",\"height\":" << (st.y1 - st.y0 + 1) << "}}";
+}
 
-    Params p = extract_args(argc, argv);
-    filesystem::create_directories(p.out_folder);
+// Возвращает false, если трассировку не удалось записать целиком
+bool trace_close(Trace& tr) {
+    if (tr.json) tr.out << "\n]}\n";
+    tr.out.close();
+    return !tr.out.fail();
+}
 
-    vector<vector<uint64_t>> grid(p.h, vector<uint64_t>(p.w, 0));
+// Возвращает false, если не удалось записать изображение или трассировку
+template <class S>
+bool run(const Params& p) {
+    conditional_t<S::dims == 3, Volume, Grid> grid;
+    if constexpr (S::dims == 3) {
+        grid.assign(p.d, Grid(p.h, vector<uint64_t>(p.w, 0)));
+    } else {
+        grid.assign(p.h, vector<uint64_t>(p.w, 0));
+    }
     read_input(p.in_file, grid);
 
+    Trace tr;
+    bool tracing = !p.trace_file.empty();
+    if (tracing && !trace_open(tr, p.trace_file)) {
+        cerr << "Cannot open trace: " << p.trace_file << endl;
+        return false;
+    }
+
     for (uint64_t i = 0; i <= p.max_steps; ++i) {
-        if (p.save_freq && i % p.save_freq == 0) {
-            string out_name = p.out_folder + "/state_" + to_string(i) + ".bmp";
-            write_image(out_name, grid);
+        if (!tracing) {
+            if (p.save_freq && i % p.save_freq == 0) {
+                if (!save_state(p.out_folder + "/state_" + to_string(i), grid, p, S::threshold)) return false;
+            }
+            if (!update<S>(grid)) {
+                cout << "Stable at iteration: " << i << endl;
+                break;
+            }
+            continue;
         }
 
-        if (!update(grid)) {
+        IterStats st;
+        st.iter = i;
+        if (p.save_freq && i % p.save_freq == 0) {
+            st.write_start = trace_now(tr);
+            if (!save_state(p.out_folder + "/state_" + to_string(i), grid, p, S::threshold)) return false;
+            st.write_us = trace_now(tr) - st.write_start;
+        }
+        st.update_start = trace_now(tr);
+        bool active = update<S>(grid, st);
+        st.update_us = trace_now(tr) - st.update_start;
+        trace_write(tr, st);
+        if (!active) {
             cout << "Stable at iteration: " << i << endl;
             break;
         }
     }
 
+    if (tracing && !trace_close(tr)) {
+        cerr << "Cannot write trace: " << p.trace_file << endl;
+        return false;
+    }
     if (p.save_freq == 0) {
-        string final_out = p.out_folder + "/final.bmp";
-        write_image(final_out, grid);
+        return save_state(p.out_folder + "/final", grid, p, S::threshold);
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 9) {
+        cout << "Usage: ./sandpiles -l <height> -w <width> -i <input.tsv> -o <output_dir> -m <max_iter> -f <freq> [-s <scale>] [-p <levels>] [-t <trace.csv|trace.json>] [-n vonneumann|moore|hex|cubic] [-d <depth>]\n";
+        return 1;
+    }
+
+    Params p = extract_args(argc, argv);
+    filesystem::create_directories(p.out_folder);
+
+    bool ok;
+    if (p.lattice == "vonneumann") {
+        ok = run<VonNeumann>(p);
+    } else if (p.lattice == "moore") {
+        ok = run<Moore>(p);
+    } else if (p.lattice == "hex") {
+        ok = run<Hex>(p);
+    } else if (p.lattice == "cubic") {
+        ok = run<Cubic>(p);
+    } else {
+        cout << "Unknown lattice: " << p.lattice << endl;
+        return 1;
     }
 
-    return 0;
+    return ok ? 0 : 2;
 }
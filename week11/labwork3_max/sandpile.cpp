@@ -0,0 +1,290 @@
+#include "sandpile.h"
+#include "stencil.h"
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+#pragma pack(push, 1)
+struct BMP {
+    uint16_t type = 0x4D42;
+    uint32_t size;
+    uint32_t reserved = 0;
+    uint32_t offset = 54;
+    uint32_t header_size = 40;
+    int32_t width;
+    int32_t height;
+    uint16_t planes = 1;
+    uint16_t bpp = 24;
+    uint32_t compression = 0;
+    uint32_t img_size = 0;
+    int32_t x_res = 1000;
+    int32_t y_res = 1000;
+    uint32_t used = 0;
+    uint32_t important = 0;
+};
+#pragma pack(pop)
+
+// Поля размеров в заголовке BMP 32-битные: файл не может превышать 4 ГиБ
+static bool bmp_fits(uint64_t img_bytes) {
+    return 54 + img_bytes <= UINT32_MAX;
+}
+
+// Цвета высот 0..7 и чёрный для неустойчивых ячеек
+const int colours = 9;
+
+uint8_t palette[colours][3] = {
+    {255, 255, 255},
+    {0, 255, 0},
+    {128, 0, 128},
+    {255, 255, 0},
+    {255, 0, 0},
+    {0, 0, 255},
+    {0, 255, 255},
+    {255, 128, 0},
+    {0, 0, 0}
+};
+
+static int colour_index(uint64_t v, uint64_t threshold) {
+    return v >= threshold || v >= colours - 1 ? colours - 1 : static_cast<int>(v);
+}
+
+// Координата из файла попадает в [0, n); отрицательные строки пропускаются
+static bool in_range(int64_t v, size_t n) {
+    return v >= 0 && static_cast<uint64_t>(v) < n;
+}
+
+void read_input(const string& path, Grid& field) {
+    ifstream in(path);
+    string ln;
+    while (getline(in, ln)) {
+        istringstream s(ln);
+        int64_t x, y;
+        uint64_t c;
+        s >> x;
+        s.ignore();
+        s >> y;
+        s.ignore();
+        s >> c;
+        if (in_range(y, field.size()) && in_range(x, field[0].size())) {
+            field[y][x] += c;
+        }
+    }
+}
+
+void read_input(const string& path, Volume& field) {
+    ifstream in(path);
+    string ln;
+    while (getline(in, ln)) {
+        istringstream s(ln);
+        int64_t x, y, z;
+        uint64_t c;
+        s >> x;
+        s.ignore();
+        s >> y;
+        s.ignore();
+        s >> z;
+        s.ignore();
+        s >> c;
+        if (in_range(z, field.size()) && in_range(y, field[0].size()) && in_range(x, field[0][0].size())) {
+            field[z][y][x] += c;
+        }
+    }
+}
+
+void write_tsv(const string& path, const Grid& field) {
+    ofstream out(path);
+    for (size_t y = 0; y < field.size(); ++y) {
+        for (size_t x = 0; x < field[y].size(); ++x) {
+            if (field[y][x]) out << x << '\t' << y << '\t' << field[y][x] << '\n';
+        }
+    }
+}
+
+static bool pwrite_all(int fd, const uint8_t* buf, size_t n, off_t off) {
+    while (n > 0) {
+        ssize_t done = pwrite(fd, buf, n, off);
+        if (done < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        buf += done;
+        n -= done;
+        off += done;
+    }
+    return true;
+}
+
+static void encode_rows(const Grid& data, int first, int last, int row_bytes, uint64_t threshold, uint8_t* out) {
+    int h = data.size();
+    int w = data[0].size();
+    for (int i = first; i < last; ++i, out += row_bytes) {
+        const vector<uint64_t>& line = data[h - 1 - i];
+        for (int x = 0; x < w; ++x) {
+            int v = colour_index(line[x], threshold);
+            out[x * 3 + 0] = palette[v][2];
+            out[x * 3 + 1] = palette[v][1];
+            out[x * 3 + 2] = palette[v][0];
+        }
+        fill(out + w * 3, out + row_bytes, 0);
+    }
+}
+
+// Смещение каждой строки в файле известно заранее, поэтому блоки строк
+// кодируются параллельно и записываются целиком через pwrite.
+// Буферы всех потоков вместе не превышают buffer_budget.
+bool write_image(const string& fname, const Grid& data, uint64_t threshold) {
+    const size_t buffer_budget = size_t(256) << 20;
+    const size_t block_cap = size_t(64) << 20;
+    const size_t serial_limit = size_t(1) << 20;
+
+    int h = data.size();
+    int w = data[0].size();
+    int row_bytes = (w * 3 + 3) & ~3;
+    size_t img_bytes = size_t(row_bytes) * h;
+    if (!bmp_fits(img_bytes)) return false;
+
+    BMP bmp;
+    bmp.size = 54 + img_bytes;
+    bmp.width = w;
+    bmp.height = h;
+    bmp.img_size = img_bytes;
+
+    int fd = open(fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    if (!pwrite_all(fd, reinterpret_cast<const uint8_t*>(&bmp), sizeof(bmp), 0)) {
+        close(fd);
+        return false;
+    }
+
+    unsigned workers = img_bytes < serial_limit ? 1 : max(1u, thread::hardware_concurrency());
+    size_t block_limit = min(block_cap, buffer_budget / workers);
+    int block_rows = static_cast<int>(max<size_t>(1, block_limit / row_bytes));
+    block_rows = min(block_rows, (h + static_cast<int>(workers) - 1) / static_cast<int>(workers));
+    int blocks = (h + block_rows - 1) / block_rows;
+    workers = min<unsigned>(workers, blocks);
+
+    atomic<int> next(0);
+    atomic<bool> ok(true);
+    auto work = [&]() {
+        vector<uint8_t> buf(size_t(block_rows) * row_bytes);
+        for (int b = next++; b < blocks && ok; b = next++) {
+            int first = b * block_rows;
+            int last = min(h, first + block_rows);
+            encode_rows(data, first, last, row_bytes, threshold, buf.data());
+            if (!pwrite_all(fd, buf.data(), size_t(last - first) * row_bytes, 54 + off_t(first) * row_bytes)) ok = false;
+        }
+    };
+
+    vector<thread> pool;
+    for (unsigned t = 1; t < workers; ++t) pool.emplace_back(work);
+    work();
+    for (auto& t : pool) t.join();
+
+    if (close(fd) != 0) ok = false;
+    return ok;
+}
+
+// Один уровень пирамиды: гистограмма цветов по блокам текущей выходной строки
+struct Level {
+    uint64_t factor;
+    int w;
+    int h;
+    int row_bytes;
+    vector<uint64_t> hist;
+    vector<uint8_t> row;
+    ofstream out;
+};
+
+static void emit_level_row(vector<Level>& levels, size_t k, int r) {
+    Level& lv = levels[k];
+    bool has_parent = k + 1 < levels.size();
+    fill(lv.row.begin(), lv.row.end(), 0);
+    for (int x = 0; x < lv.w; ++x) {
+        uint64_t* cnt = &lv.hist[x * colours];
+        int best = 0;
+        for (int c = 1; c < colours; ++c) {
+            if (cnt[c] >= cnt[best]) best = c;
+        }
+        lv.row[x * 3 + 0] = palette[best][2];
+        lv.row[x * 3 + 1] = palette[best][1];
+        lv.row[x * 3 + 2] = palette[best][0];
+        if (has_parent) {
+            uint64_t* up = &levels[k + 1].hist[(x / 2) * colours];
+            for (int c = 0; c < colours; ++c) up[c] += cnt[c];
+        }
+    }
+    lv.out.write(reinterpret_cast<char*>(lv.row.data()), lv.row_bytes);
+    fill(lv.hist.begin(), lv.hist.end(), 0);
+
+    // Строка родителя собрана, когда записана верхняя из двух его дочерних строк
+    if (has_parent && r % 2 == 0) emit_level_row(levels, k + 1, r / 2);
+}
+
+// Уменьшенное изображение (цвет блока scale x scale выбирается по большинству)
+// и, при levels > 0, пирамида уровней с коэффициентами scale * 2^k.
+// Сетка читается один раз, память на уровень пропорциональна одной выходной строке.
+bool write_pyramid(const string& base, const Grid& data, uint32_t scale, uint32_t levels, uint64_t threshold) {
+    int h = data.size();
+    int w = data[0].size();
+
+    vector<Level> lv;
+    uint64_t f = scale;
+    for (uint32_t k = 0; k <= levels; ++k) {
+        Level cur;
+        cur.factor = f;
+        cur.w = static_cast<int>((w + f - 1) / f);
+        cur.h = static_cast<int>((h + f - 1) / f);
+        cur.row_bytes = (cur.w * 3 + 3) & ~3;
+        cur.hist.assign(cur.w * colours, 0);
+        cur.row.resize(cur.row_bytes);
+
+        uint64_t img_bytes = uint64_t(cur.row_bytes) * cur.h;
+        if (!bmp_fits(img_bytes)) return false;
+        BMP bmp;
+        bmp.size = 54 + img_bytes;
+        bmp.width = cur.w;
+        bmp.height = cur.h;
+        bmp.img_size = img_bytes;
+
+        string fname = k == 0 ? base + ".bmp" : base + "_lvl" + to_string(k) + ".bmp";
+        cur.out.open(fname, ios::binary);
+        if (!cur.out) return false;
+        cur.out.write(reinterpret_cast<char*>(&bmp), sizeof(bmp));
+        lv.push_back(move(cur));
+
+        if (lv.back().w == 1 && lv.back().h == 1) break;
+        f *= 2;
+    }
+
+    uint64_t f0 = lv[0].factor;
+    uint64_t* hist = lv[0].hist.data();
+    for (int y = h - 1; y >= 0; --y) {
+        const vector<uint64_t>& line = data[y];
+        for (int x = 0; x < w; ++x) {
+            ++hist[(x / f0) * colours + colour_index(line[x], threshold)];
+        }
+        if (y % f0 == 0) emit_level_row(lv, 0, static_cast<int>(y / f0));
+    }
+
+    bool ok = true;
+    for (Level& l : lv) {
+        l.out.close();
+        if (!l.out) ok = false;
+    }
+    return ok;
+}
+
+bool update(Grid& mat) {
+    return update<VonNeumann>(mat);
+}
+
+bool update(Grid& mat, IterStats& st) {
+    return update<VonNeumann>(mat, st);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using Grid = std::vector<std::vector<uint64_t>>;
+using Volume = std::vector<Grid>;
+
+// Метрики одной итерации; рамка активных ячеек пуста, если x0 > x1
+struct IterStats {
+    uint64_t iter = 0;
+    uint64_t toppled = 0;
+    uint64_t lost = 0;
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = -1;
+    int y1 = -1;
+    uint64_t max_height = 0;
+    double update_start = 0;
+    double update_us = 0;
+    double write_start = 0;
+    double write_us = 0;
+};
+
+// Строки TSV: x, y, количество (для объёма: x, y, z, количество)
+void read_input(const std::string& path, Grid& field);
+void read_input(const std::string& path, Volume& field);
+void write_tsv(const std::string& path, const Grid& field);
+
+// Ячейки с высотой >= threshold рисуются чёрным.
+// Возвращают false, если файл не удалось открыть или записать целиком
+bool write_image(const std::string& fname, const Grid& data, uint64_t threshold = 4);
+bool write_pyramid(const std::string& base, const Grid& data, uint32_t scale, uint32_t levels, uint64_t threshold = 4);
+
+// Одна итерация модели на решётке фон Неймана; возвращает false, если осыпаний не было.
+// Другие решётки: update<S>() из stencil.h
+bool update(Grid& mat);
+bool update(Grid& mat, IterStats& st);
@@ -0,0 +1,173 @@
+#include "sandpile_group.h"
+#include "stencil.h"
+
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace std;
+
+Sandpile::Sandpile(int h, int w, uint64_t fill) : cells_(h, vector<uint64_t>(w, fill)) {}
+
+Sandpile::Sandpile(Grid cells) : cells_(move(cells)) {}
+
+int Sandpile::height() const {
+    return cells_.size();
+}
+
+int Sandpile::width() const {
+    return cells_.empty() ? 0 : static_cast<int>(cells_[0].size());
+}
+
+uint64_t& Sandpile::at(int y, int x) {
+    return cells_[y][x];
+}
+
+uint64_t Sandpile::at(int y, int x) const {
+    return cells_[y][x];
+}
+
+const Grid& Sandpile::cells() const {
+    return cells_;
+}
+
+bool Sandpile::is_stable() const {
+    for (const auto& row : cells_) {
+        for (uint64_t v : row) {
+            if (v >= VonNeumann::threshold) return false;
+        }
+    }
+    return true;
+}
+
+// Ячейка сгорает, когда её высота не меньше числа ещё не сгоревших соседей в сетке
+// (рёбра в сток и к сгоревшим ячейкам уже горят). Каждая ячейка попадает в очередь один раз
+bool Sandpile::is_recurrent() const {
+    if (!is_stable()) return false;
+    int h = height();
+    int w = width();
+    vector<uint8_t> unburnt(size_t(h) * w);
+    vector<bool> burnt(size_t(h) * w, false);
+    deque<int> fire;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            int i = y * w + x;
+            unburnt[i] = (y > 0) + (y + 1 < h) + (x > 0) + (x + 1 < w);
+            if (cells_[y][x] >= unburnt[i]) {
+                burnt[i] = true;
+                fire.push_back(i);
+            }
+        }
+    }
+    size_t count = fire.size();
+    while (!fire.empty()) {
+        int i = fire.front();
+        fire.pop_front();
+        int y = i / w;
+        int x = i % w;
+        for (const Offset& o : VonNeumann::offsets) {
+            int ny = y + o.dy;
+            int nx = x + o.dx;
+            if (ny < 0 || ny >= h || nx < 0 || nx >= w) continue;
+            int j = ny * w + nx;
+            if (burnt[j]) continue;
+            if (cells_[ny][nx] >= --unburnt[j]) {
+                burnt[j] = true;
+                fire.push_back(j);
+                ++count;
+            }
+        }
+    }
+    return count == burnt.size();
+}
+
+Sandpile& Sandpile::stabilise() {
+    ::stabilise<VonNeumann>(cells_);
+    return *this;
+}
+
+Sandpile& Sandpile::operator+=(const Sandpile& other) {
+    if (height() != other.height() || width() != other.width()) {
+        throw invalid_argument("Sandpile sizes differ");
+    }
+    for (int y = 0; y < height(); ++y) {
+        for (int x = 0; x < width(); ++x) cells_[y][x] += other.cells_[y][x];
+    }
+    return stabilise();
+}
+
+Sandpile Sandpile::operator+(const Sandpile& other) const {
+    Sandpile res = *this;
+    res += other;
+    return res;
+}
+
+bool Sandpile::operator==(const Sandpile& other) const {
+    return cells_ == other.cells_;
+}
+
+bool Sandpile::operator!=(const Sandpile& other) const {
+    return !(*this == other);
+}
+
+Sandpile Sandpile::compute_identity(int h, int w) {
+    const uint64_t twice_max = 2 * (VonNeumann::threshold - 1);
+    Sandpile s(h, w, twice_max);
+    s.stabilise();
+    for (auto& row : s.cells_) {
+        for (uint64_t& v : row) v = twice_max - v;
+    }
+    return s.stabilise();
+}
+
+string Sandpile::cache_dir() {
+    const char* env = getenv("SANDPILE_CACHE_DIR");
+    if (env && *env) return env;
+    return (filesystem::temp_directory_path() / "sandpile_cache").string();
+}
+
+// Строгое чтение кэша: любая строка вне формата x, y, высота или вне сетки делает его негодным
+static bool read_cache(const string& path, Grid& cells) {
+    ifstream in(path);
+    if (!in) return false;
+    string ln;
+    while (getline(in, ln)) {
+        istringstream s(ln);
+        int64_t x, y;
+        uint64_t c;
+        if (!(s >> x >> y >> c)) return false;
+        if (y < 0 || x < 0 || static_cast<uint64_t>(y) >= cells.size() || static_cast<uint64_t>(x) >= cells[0].size()) {
+            return false;
+        }
+        cells[y][x] = c;
+    }
+    return in.eof();
+}
+
+Sandpile Sandpile::identity(int h, int w) {
+    filesystem::path dir = cache_dir();
+    filesystem::path file = dir / ("identity_" + to_string(h) + "x" + to_string(w) + ".tsv");
+
+    error_code ec;
+    if (filesystem::exists(file, ec)) {
+        Sandpile s(h, w);
+        if (read_cache(file.string(), s.cells_) && s.is_recurrent()) return s;
+    }
+
+    Sandpile s = compute_identity(h, w);
+
+    // Запись во временный файл и переименование, чтобы параллельные процессы не читали неполный кэш
+    filesystem::create_directories(dir, ec);
+    if (!ec) {
+        filesystem::path tmp = file;
+        tmp += ".tmp" + to_string(getpid());
+        write_tsv(tmp.string(), s.cells_);
+        filesystem::rename(tmp, file, ec);
+        if (ec) filesystem::remove(tmp, ec);
+    }
+    return s;
+}
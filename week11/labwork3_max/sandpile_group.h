@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "sandpile.h"
+
+// Элемент группы песчаных куч сетки h x w (решётка фон Неймана, сток на границе)
+class Sandpile {
+public:
+    Sandpile(int h, int w, uint64_t fill = 0);
+    explicit Sandpile(Grid cells);
+
+    int height() const;
+    int width() const;
+    uint64_t& at(int y, int x);
+    uint64_t at(int y, int x) const;
+    const Grid& cells() const;
+
+    bool is_stable() const;
+    // Тест сжигания Дхара за один проход без стабилизации: устойчивая куча рекуррентна
+    // (лежит в группе), если огонь от стока сжигает все ячейки
+    bool is_recurrent() const;
+    // Стабилизация на месте однопоточным ядром stabilise<VonNeumann>() из stencil.h
+    Sandpile& stabilise();
+
+    // Сложение по ячейкам с последующей стабилизацией
+    Sandpile& operator+=(const Sandpile& other);
+    Sandpile operator+(const Sandpile& other) const;
+    bool operator==(const Sandpile& other) const;
+    bool operator!=(const Sandpile& other) const;
+
+    // Нейтральный элемент: (6 - (6)°)°. Результат кэшируется на диске для каждого размера
+    // в каталоге cache_dir() (переменная окружения SANDPILE_CACHE_DIR или временный каталог).
+    // При чтении кэша проверяются только размеры, высоты 0..3 и рекуррентность (без стабилизаций);
+    // не прошедший проверку файл пересчитывается и перезаписывается
+    static Sandpile identity(int h, int w);
+    static Sandpile compute_identity(int h, int w);
+    static std::string cache_dir();
+
+private:
+    Grid cells_;
+};
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "sandpile.h"
+
+// Описание решётки: размерность, порог осыпания и смещения соседей.
+// Все поля constexpr, поэтому ядро update<S>() разворачивается под каждую решётку
+// без ветвлений по типу окрестности.
+struct Offset {
+    int dz;
+    int dy;
+    int dx;
+};
+
+// 4 соседа, порог 4
+struct VonNeumann {
+    static constexpr int dims = 2;
+    static constexpr uint64_t threshold = 4;
+    static constexpr std::array<Offset, 4> offsets{{
+        {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}
+    }};
+};
+
+// 8 соседей, порог 8
+struct Moore {
+    static constexpr int dims = 2;
+    static constexpr uint64_t threshold = 8;
+    static constexpr std::array<Offset, 8> offsets{{
+        {0, -1, -1}, {0, -1, 0}, {0, -1, 1},
+        {0, 0, -1}, {0, 0, 1},
+        {0, 1, -1}, {0, 1, 0}, {0, 1, 1}
+    }};
+};
+
+// Шестиугольная решётка в осевых координатах (строка r, столбец q), порог 6
+struct Hex {
+    static constexpr int dims = 2;
+    static constexpr uint64_t threshold = 6;
+    static constexpr std::array<Offset, 6> offsets{{
+        {0, -1, 0}, {0, -1, 1}, {0, 0, -1}, {0, 0, 1}, {0, 1, -1}, {0, 1, 0}
+    }};
+};
+
+// Кубическая 3D решётка, порог 6
+struct Cubic {
+    static constexpr int dims = 3;
+    static constexpr uint64_t threshold = 6;
+    static constexpr std::array<Offset, 6> offsets{{
+        {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}
+    }};
+};
+
+namespace stencil_detail {
+
+template <class S>
+constexpr bool unit_offsets() {
+    for (const Offset& o : S::offsets) {
+        if (o.dz < -1 || o.dz > 1 || o.dy < -1 || o.dy > 1 || o.dx < -1 || o.dx > 1) return false;
+        if (S::dims == 2 && o.dz != 0) return false;
+    }
+    return true;
+}
+
+inline bool inside(int v, int n) {
+    return v >= 0 && v < n;
+}
+
+// Раздаёт drop песчинок соседям; возвращает число песчинок, ушедших за границу
+template <class S, bool Checked, size_t... I>
+inline uint64_t scatter(Grid* next, int d, int h, int w, int z, int y, int x, uint64_t drop,
+                        std::index_sequence<I...>) {
+    uint64_t lost = 0;
+    if constexpr (Checked) {
+        ((inside(z + S::offsets[I].dz, d) && inside(y + S::offsets[I].dy, h) && inside(x + S::offsets[I].dx, w)
+              ? void(next[z + S::offsets[I].dz][y + S::offsets[I].dy][x + S::offsets[I].dx] += drop)
+              : void(lost += drop)),
+         ...);
+    } else {
+        ((next[z + S::offsets[I].dz][y + S::offsets[I].dy][x + S::offsets[I].dx] += drop), ...);
+    }
+    return lost;
+}
+
+// Синхронное обновление: cur только читается, next до вызова равен cur
+template <class S, bool Collect>
+bool topple(const Grid* cur, Grid* next, int d, IterStats* st) {
+    static_assert(unit_offsets<S>(), "stencil offsets must lie within one cell");
+    constexpr auto seq = std::make_index_sequence<S::offsets.size()>();
+    int h = cur[0].size();
+    int w = cur[0][0].size();
+    bool active = false;
+
+    for (int z = 0; z < d; ++z) {
+        bool z_inner = S::dims == 2 || (z > 0 && z + 1 < d);
+        for (int y = 0; y < h; ++y) {
+            bool y_inner = z_inner && y > 0 && y + 1 < h;
+            const uint64_t* line = cur[z][y].data();
+            for (int x = 0; x < w; ++x) {
+                uint64_t v = line[x];
+                if (Collect && v > st->max_height) st->max_height = v;
+                if (v < S::threshold) continue;
+
+                uint64_t drop = v / S::threshold;
+                next[z][y][x] -= drop * S::threshold;
+                uint64_t lost = 0;
+                if (y_inner && x > 0 && x + 1 < w) {
+                    scatter<S, false>(next, d, h, w, z, y, x, drop, seq);
+                } else {
+                    lost = scatter<S, true>(next, d, h, w, z, y, x, drop, seq);
+                }
+                active = true;
+                if (Collect) {
+                    ++st->toppled;
+                    st->lost += lost;
+                    if (st->x0 > st->x1) {
+                        st->x0 = st->x1 = x;
+                        st->y0 = st->y1 = y;
+                    } else {
+                        st->x0 = std::min(st->x0, x);
+                        st->x1 = std::max(st->x1, x);
+                        st->y0 = std::min(st->y0, y);
+                        st->y1 = std::max(st->y1, y);
+                    }
+                }
+            }
+        }
+    }
+    return active;
+}
+
+} // namespace stencil_detail
+
+// Одна итерация модели на решётке S; рамка в IterStats для 3D — проекция на (y, x)
+template <class S>
+bool update(Grid& mat) {
+    static_assert(S::dims == 2, "2D stencil expected");
+    Grid next = mat;
+    bool active = stencil_detail::topple<S, false>(&mat, &next, 1, nullptr);
+    mat.swap(next);
+    return active;
+}
+
+template <class S>
+bool update(Grid& mat, IterStats& st) {
+    static_assert(S::dims == 2, "2D stencil expected");
+    Grid next = mat;
+    bool active = stencil_detail::topple<S, true>(&mat, &next, 1, &st);
+    mat.swap(next);
+    return active;
+}
+
+template <class S>
+bool update(Volume& vol) {
+    static_assert(S::dims == 3, "3D stencil expected");
+    Volume next = vol;
+    bool active = stencil_detail::topple<S, false>(vol.data(), next.data(), vol.size(), nullptr);
+    vol.swap(next);
+    return active;
+}
+
+template <class S>
+bool update(Volume& vol, IterStats& st) {
+    static_assert(S::dims == 3, "3D stencil expected");
+    Volume next = vol;
+    bool active = stencil_detail::topple<S, true>(vol.data(), next.data(), vol.size(), &st);
+    vol.swap(next);
+    return active;
+}
+
+// Полная стабилизация на месте: обходы сетки без временной копии, пока есть неустойчивые ячейки.
+// По абелеву свойству результат совпадает с повторением update<S>(), но сходится быстрее.
+// Возвращает число песчинок, ушедших за границу.
+template <class S>
+uint64_t stabilise(Grid& mat) {
+    static_assert(S::dims == 2, "2D stencil expected");
+    static_assert(stencil_detail::unit_offsets<S>(), "stencil offsets must lie within one cell");
+    constexpr auto seq = std::make_index_sequence<S::offsets.size()>();
+    int h = mat.size();
+    int w = h ? static_cast<int>(mat[0].size()) : 0;
+    uint64_t lost = 0;
+
+    for (bool active = true; active;) {
+        active = false;
+        for (int y = 0; y < h; ++y) {
+            bool y_inner = y > 0 && y + 1 < h;
+            for (int x = 0; x < w; ++x) {
+                uint64_t v = mat[y][x];
+                if (v < S::threshold) continue;
+                uint64_t drop = v / S::threshold;
+                mat[y][x] -= drop * S::threshold;
+                if (y_inner && x > 0 && x + 1 < w) {
+                    stencil_detail::scatter<S, false>(&mat, 1, h, w, 0, y, x, drop, seq);
+                } else {
+                    lost += stencil_detail::scatter<S, true>(&mat, 1, h, w, 0, y, x, drop, seq);
+                }
+                active = true;
+            }
+        }
+    }
+    return lost;
+}
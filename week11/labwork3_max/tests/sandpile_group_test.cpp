@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "sandpile_group.h"
+
+namespace {
+
+Sandpile random_stable(int h, int w, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint64_t> d(0, 3);
+    Sandpile s(h, w);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) s.at(y, x) = d(rng);
+    }
+    return s;
+}
+
+// Отдельный каталог кэша на тест, чтобы не зависеть от уже записанных файлов
+class IdentityCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = std::filesystem::temp_directory_path() /
+               ("sandpile_cache_test_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove_all(dir_);
+        setenv("SANDPILE_CACHE_DIR", dir_.c_str(), 1);
+    }
+
+    void TearDown() override {
+        unsetenv("SANDPILE_CACHE_DIR");
+        std::filesystem::remove_all(dir_);
+    }
+
+    std::filesystem::path file(int h, int w) const {
+        return dir_ / ("identity_" + std::to_string(h) + "x" + std::to_string(w) + ".tsv");
+    }
+
+    std::filesystem::path dir_;
+};
+
+} // namespace
+
+TEST(SandpileGroupTest, IdentityIsIdempotent) {
+    Sandpile e = Sandpile::compute_identity(5, 7);
+    ASSERT_TRUE(e.is_stable());
+    ASSERT_EQ(e + e, e);
+    ASSERT_TRUE(e.is_recurrent());
+}
+
+TEST(SandpileGroupTest, IdentityIsNeutralForRecurrent) {
+    Sandpile e = Sandpile::compute_identity(4, 6);
+    // Максимальная устойчивая куча рекуррентна, как и любая сумма с ней
+    Sandpile full(4, 6, 3);
+    ASSERT_EQ(full + e, full);
+    Sandpile c = full + random_stable(4, 6, 1);
+    ASSERT_EQ(c + e, c);
+    ASSERT_EQ(e + c, c);
+}
+
+TEST(SandpileGroupTest, Commutative) {
+    for (unsigned seed = 0; seed < 8; ++seed) {
+        Sandpile a = random_stable(6, 5, seed);
+        Sandpile b = random_stable(6, 5, seed + 100);
+        ASSERT_EQ(a + b, b + a);
+    }
+}
+
+TEST(SandpileGroupTest, Recurrence) {
+    // Нуль идемпотентен, но не рекуррентен; максимальная устойчивая куча рекуррентна
+    Sandpile zero(3, 3);
+    ASSERT_EQ(zero + zero, zero);
+    ASSERT_FALSE(zero.is_recurrent());
+    ASSERT_TRUE(Sandpile(3, 3, 3).is_recurrent());
+    ASSERT_FALSE(Sandpile(3, 3, 4).is_recurrent());
+
+    // Сжигание за один проход совпадает с критерием (c + β)° == c
+    for (unsigned seed = 0; seed < 32; ++seed) {
+        Sandpile c = random_stable(4, 5, seed);
+        Sandpile burnt = c;
+        for (int y = 0; y < 4; ++y) {
+            for (int x = 0; x < 5; ++x) burnt.at(y, x) += (y == 0) + (y == 3) + (x == 0) + (x == 4);
+        }
+        ASSERT_EQ(c.is_recurrent(), burnt.stabilise() == c) << seed;
+    }
+}
+
+TEST_F(IdentityCacheTest, RoundTrip) {
+    Sandpile e = Sandpile::identity(6, 4);
+    ASSERT_TRUE(std::filesystem::exists(file(6, 4)));
+    ASSERT_EQ(e, Sandpile::compute_identity(6, 4));
+    Sandpile cached = Sandpile::identity(6, 4);
+    ASSERT_EQ(cached, e);
+    // Полный закон группы проверяется здесь, а не при каждом чтении кэша
+    ASSERT_EQ(cached + cached, cached);
+    ASSERT_EQ(Sandpile::identity(6, 4), cached);
+}
+
+TEST_F(IdentityCacheTest, EmptyCacheRecomputed) {
+    std::filesystem::create_directories(dir_);
+    std::ofstream(file(4, 4)).close();
+    ASSERT_EQ(Sandpile::identity(4, 4), Sandpile::compute_identity(4, 4));
+    ASSERT_GT(std::filesystem::file_size(file(4, 4)), 0u);
+}
+
+TEST_F(IdentityCacheTest, WrongSizeRecomputed) {
+    Sandpile big = Sandpile::identity(5, 5);
+    std::filesystem::copy_file(file(5, 5), file(3, 3));
+    ASSERT_EQ(Sandpile::identity(3, 3), Sandpile::compute_identity(3, 3));
+    ASSERT_EQ(Sandpile::identity(5, 5), big);
+}
+
+TEST_F(IdentityCacheTest, BadHeightsRecomputed) {
+    std::filesystem::create_directories(dir_);
+    {
+        std::ofstream out(file(3, 3));
+        out << "0\t0\t9\n";
+    }
+    ASSERT_EQ(Sandpile::identity(3, 3), Sandpile::compute_identity(3, 3));
+    {
+        std::ofstream out(file(3, 3));
+        out << "0\tx\t1\n";
+    }
+    ASSERT_EQ(Sandpile::identity(3, 3), Sandpile::compute_identity(3, 3));
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "sandpile.h"
+#include "stencil.h"
+
+// Одиночная куча ровно в пороге посреди сетки 3 x 3 (3 x 3 x 3 для cubic):
+// за одну итерацию центр обнуляется, каждый сосед решётки получает по песчинке.
+
+TEST(StencilTest, MooreCentre) {
+    Grid g(3, std::vector<uint64_t>(3, 0));
+    g[1][1] = 8;
+    ASSERT_TRUE(update<Moore>(g));
+    Grid expected = {{1, 1, 1}, {1, 0, 1}, {1, 1, 1}};
+    ASSERT_EQ(g, expected);
+    ASSERT_FALSE(update<Moore>(g));
+}
+
+TEST(StencilTest, MooreCornerLoses) {
+    Grid g(3, std::vector<uint64_t>(3, 0));
+    g[0][0] = 8;
+    IterStats st;
+    ASSERT_TRUE(update<Moore>(g, st));
+    Grid expected = {{0, 1, 0}, {1, 1, 0}, {0, 0, 0}};
+    ASSERT_EQ(g, expected);
+    ASSERT_EQ(st.toppled, 1u);
+    ASSERT_EQ(st.lost, 5u);
+}
+
+TEST(StencilTest, HexCentre) {
+    Grid g(3, std::vector<uint64_t>(3, 0));
+    g[1][1] = 6;
+    ASSERT_TRUE(update<Hex>(g));
+    // В осевых координатах соседи (-1,-1) и (1,1) не смежны с центром
+    Grid expected = {{0, 1, 1}, {1, 0, 1}, {1, 1, 0}};
+    ASSERT_EQ(g, expected);
+}
+
+TEST(StencilTest, HexBelowThreshold) {
+    Grid g(3, std::vector<uint64_t>(3, 0));
+    g[1][1] = 5;
+    Grid before = g;
+    ASSERT_FALSE(update<Hex>(g));
+    ASSERT_EQ(g, before);
+}
+
+TEST(StencilTest, CubicCentre) {
+    Volume v(3, Grid(3, std::vector<uint64_t>(3, 0)));
+    v[1][1][1] = 6;
+    IterStats st;
+    ASSERT_TRUE(update<Cubic>(v, st));
+    ASSERT_EQ(st.lost, 0u);
+    Volume expected(3, Grid(3, std::vector<uint64_t>(3, 0)));
+    expected[0][1][1] = expected[2][1][1] = 1;
+    expected[1][0][1] = expected[1][2][1] = 1;
+    expected[1][1][0] = expected[1][1][2] = 1;
+    ASSERT_EQ(v, expected);
+}
+
+TEST(StencilTest, StabiliseMatchesRepeatedUpdate) {
+    Grid a(5, std::vector<uint64_t>(5, 0));
+    a[2][2] = 100;
+    Grid b = a;
+    stabilise<Moore>(a);
+    while (update<Moore>(b)) {
+    }
+    ASSERT_EQ(a, b);
+}
+
+TEST(ReadInputTest, SkipsOutOfRange) {
+    std::string path = (std::filesystem::temp_directory_path() / "sandpile_read_input_test.tsv").string();
+    {
+        std::ofstream out(path);
+        out << "1\t2\t5\n-1\t0\t7\n0\t-1\t7\n3\t0\t7\n0\t3\t7\n1\t2\t1\n";
+    }
+    Grid g(3, std::vector<uint64_t>(3, 0));
+    read_input(path, g);
+    std::filesystem::remove(path);
+    Grid expected = {{0, 0, 0}, {0, 0, 0}, {0, 6, 0}};
+    ASSERT_EQ(g, expected);
+}
+
+TEST(WriteImageTest, ReportsOpenFailure) {
+    std::string base = (std::filesystem::temp_directory_path() / "sandpile_missing_dir" / "state").string();
+    Grid g(4, std::vector<uint64_t>(4, 1));
+    ASSERT_FALSE(write_image(base + ".bmp", g));
+    ASSERT_FALSE(write_pyramid(base, g, 1, 2));
+
+    std::string ok = (std::filesystem::temp_directory_path() / "sandpile_pyramid_test").string();
+    ASSERT_TRUE(write_pyramid(ok, g, 1, 1));
+    ASSERT_EQ(std::filesystem::file_size(ok + ".bmp"), 54u + 12u * 4);
+    ASSERT_EQ(std::filesystem::file_size(ok + "_lvl1.bmp"), 54u + 8u * 2);
+    std::filesystem::remove(ok + ".bmp");
+    std::filesystem::remove(ok + "_lvl1.bmp");
+}
@@ -0,0 +1,204 @@
+#include <benchmark/benchmark.h>
+#include <lib/ArgParser.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace ArgumentParser;
+
+// Глобальный счётчик выделений памяти: число вызовов operator new и байты.
+// Заменяются все формы new/delete (массивы, выравнивание, nothrow, sized delete),
+// чтобы каждая пара выделения и освобождения шла через malloc/free
+namespace {
+    std::atomic<size_t> g_allocs{0};
+    std::atomic<size_t> g_bytes{0};
+
+    void* Allocate(size_t size, size_t align) noexcept {
+        g_allocs.fetch_add(1, std::memory_order_relaxed);
+        g_bytes.fetch_add(size, std::memory_order_relaxed);
+        if (size == 0) size = 1;
+        if (align <= alignof(std::max_align_t)) return std::malloc(size);
+        // aligned_alloc требует размер, кратный выравниванию
+        return std::aligned_alloc(align, (size + align - 1) / align * align);
+    }
+
+    void* AllocateOrThrow(size_t size, size_t align) {
+        if (void* p = Allocate(size, align)) return p;
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(size_t size) { return AllocateOrThrow(size, 0); }
+void* operator new[](size_t size) { return AllocateOrThrow(size, 0); }
+void* operator new(size_t size, std::align_val_t align) { return AllocateOrThrow(size, static_cast<size_t>(align)); }
+void* operator new[](size_t size, std::align_val_t align) { return AllocateOrThrow(size, static_cast<size_t>(align)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return Allocate(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return Allocate(size, 0); }
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return Allocate(size, static_cast<size_t>(align));
+}
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return Allocate(size, static_cast<size_t>(align));
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+
+namespace {
+
+// Наборы аргументов
+enum Mix { FLAGS = 0, NAMED = 1, CLUSTERS = 2, POSITIONAL = 3 };
+
+const char* MixName(int mix) {
+    switch (mix) {
+        case FLAGS: return "flags";
+        case NAMED: return "named";
+        case CLUSTERS: return "clusters";
+        default: return "positional";
+    }
+}
+
+// Схема: 26 флагов a..z, 16 строковых опций и позиционный список чисел
+void DefineSchema(ArgParser& parser) {
+    for (char c = 'a'; c <= 'z'; ++c) parser.AddFlag(c, std::string("flag_") + c);
+    for (int i = 0; i < 16; ++i) parser.AddStringArgument("opt" + std::to_string(i)).Default("none");
+    parser.AddIntArgument("N").MultiValue().Positional();
+}
+
+std::vector<std::string> MakeArgs(int mix, size_t count) {
+    std::vector<std::string> args = {"app"};
+    args.reserve(count + 1);
+    for (size_t i = 0; i < count; ++i) {
+        switch (mix) {
+            case FLAGS: args.push_back(std::string("--flag_") + char('a' + i % 26)); break;
+            case NAMED: args.push_back("--opt" + std::to_string(i % 16) + "=value" + std::to_string(i)); break;
+            case CLUSTERS: args.push_back("-abcdefgh"); break;
+            default: args.push_back(std::to_string(i)); break;
+        }
+    }
+    return args;
+}
+
+// Счётчики на один разбор и время на аргумент
+void ReportAllocs(benchmark::State& state, size_t allocs, size_t bytes, size_t argsPerIter) {
+    state.counters["allocs/parse"] = benchmark::Counter(static_cast<double>(allocs), benchmark::Counter::kAvgIterations);
+    state.counters["bytes/parse"] = benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+    state.counters["time/arg"] = benchmark::Counter(static_cast<double>(argsPerIter),
+        benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+} // namespace
+
+static void BM_Construct(benchmark::State& state) {
+    size_t options = state.range(0);
+    size_t allocs = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        size_t a0 = g_allocs, b0 = g_bytes;
+        ArgParser parser("app");
+        for (size_t i = 0; i < options; ++i) {
+            parser.AddIntArgument("option" + std::to_string(i), "benchmark option").Default(0);
+        }
+        benchmark::DoNotOptimize(parser);
+        allocs += g_allocs - a0;
+        bytes += g_bytes - b0;
+    }
+    state.counters["allocs/construct"] = benchmark::Counter(static_cast<double>(allocs), benchmark::Counter::kAvgIterations);
+    state.counters["bytes/construct"] = benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_Construct)->RangeMultiplier(10)->Range(10, 1000);
+
+// Разбор argv в переиспользуемый ParseResult (const Parse)
+static void BM_Parse(benchmark::State& state) {
+    int mix = state.range(0);
+    size_t count = state.range(1);
+    ArgParser parser("app");
+    DefineSchema(parser);
+    std::vector<std::string> args = MakeArgs(mix, count);
+    std::vector<char*> argv;
+    for (auto& a : args) argv.push_back(a.data());
+    ParseResult result;
+
+    size_t allocs = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        size_t a0 = g_allocs, b0 = g_bytes;
+        bool ok = parser.Parse(static_cast<int>(argv.size()), argv.data(), result);
+        allocs += g_allocs - a0;
+        bytes += g_bytes - b0;
+        if (!ok) state.SkipWithError("parse failed");
+    }
+    ReportAllocs(state, allocs, bytes, count);
+    state.SetLabel(MixName(mix));
+}
+BENCHMARK(BM_Parse)
+    ->ArgsProduct({{FLAGS, NAMED, CLUSTERS, POSITIONAL}, benchmark::CreateRange(10, 1000000, 10)})
+    ->ArgNames({"mix", "args"})
+    ->Unit(benchmark::kMicrosecond);
+
+// Разбор с записью в переменные StoreValue (Parse без ParseResult)
+static void BM_ParseStore(benchmark::State& state) {
+    size_t count = state.range(0);
+    ArgParser parser("app");
+    std::vector<int> values;
+    parser.AddIntArgument("N").MultiValue().Positional().StoreValues(values);
+    std::vector<std::string> args = MakeArgs(POSITIONAL, count);
+    std::vector<char*> argv;
+    for (auto& a : args) argv.push_back(a.data());
+
+    size_t allocs = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        size_t a0 = g_allocs, b0 = g_bytes;
+        benchmark::DoNotOptimize(parser.Parse(static_cast<int>(argv.size()), argv.data()));
+        allocs += g_allocs - a0;
+        bytes += g_bytes - b0;
+    }
+    ReportAllocs(state, allocs, bytes, count);
+}
+BENCHMARK(BM_ParseStore)->RangeMultiplier(100)->Range(10, 1000000)->Unit(benchmark::kMicrosecond);
+
+// Ошибочный ввод: неверное значение в конце или неизвестная опция в начале
+static void BM_ParseError(benchmark::State& state) {
+    size_t count = state.range(0);
+    bool early = state.range(1);
+    ArgParser parser("app");
+    DefineSchema(parser);
+    std::vector<std::string> args = MakeArgs(POSITIONAL, count);
+    if (early) args.insert(args.begin() + 1, "--unknown");
+    else args.push_back("12abc");
+    std::vector<char*> argv;
+    for (auto& a : args) argv.push_back(a.data());
+    ParseResult result;
+
+    size_t allocs = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        size_t a0 = g_allocs, b0 = g_bytes;
+        benchmark::DoNotOptimize(parser.Parse(static_cast<int>(argv.size()), argv.data(), result));
+        allocs += g_allocs - a0;
+        bytes += g_bytes - b0;
+    }
+    ReportAllocs(state, allocs, bytes, count);
+    state.SetLabel(early ? "unknown option first" : "bad value last");
+}
+BENCHMARK(BM_ParseError)
+    ->ArgsProduct({benchmark::CreateRange(10, 100000, 100), {0, 1}})
+    ->ArgNames({"args", "early"})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
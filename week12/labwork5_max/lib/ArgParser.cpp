@@ -21,138 +21,16 @@ namespace ArgumentParser {
      */
     ArgParser::Option& ArgParser::CreateOption(ArgType type, char shortName, const std::string& longName, const std::string& description) {
         options_.push_back({});
+        descriptions_.push_back(description);
         Option& opt = options_.back();
         opt.type = type;
-        opt.longName = longName;
         opt.shortName = shortName;
-        opt.description = description;
-        if (type == ArgType::Flag || type == ArgType::Help) {
-            opt.valueBool = false;
-        }
         size_t idx = options_.size() - 1;
         if (!longName.empty()) longNameMap_[longName] = idx;
         if (shortName) shortNameMap_[shortName] = idx;
         return opt;
     }
 
-    // Реализации методов ArgBuilder
-
-    /**
-     * @brief Конструктор построителя аргументов
-     * @param parser Ссылка на парсер аргументов
-     * @param index Индекс опции в списке
-     */
-    ArgParser::ArgBuilder::ArgBuilder(ArgParser& parser, size_t index)
-        : parser_(parser), index_(index) {
-    }
-
-    /**
-     * @brief Устанавливает строковое значение по умолчанию
-     * @param defaultValue Значение по умолчанию
-     * @return Ссылка на себя для цепочки вызовов
-     */
-    ArgParser::ArgBuilder& ArgParser::ArgBuilder::Default(const std::string& defaultValue) {
-        auto& opt = parser_.options_[index_];
-        opt.hasDefault = true;
-        opt.defaultString = defaultValue;
-        return *this;
-    }
-
-    /**
-     * @brief Устанавливает целочисленное значение по умолчанию
-     * @param defaultValue Значение по умолчанию
-     * @return Ссылка на себя для цепочки вызовов
-     */
-    ArgParser::ArgBuilder& ArgParser::ArgBuilder::Default(int defaultValue) {
-        auto& opt = parser_.options_[index_];
-        opt.hasDefault = true;
-        opt.defaultInt = defaultValue;
-        return *this;
-    }
-
-    /**
-     * @brief Устанавливает булево значение по умолчанию
-     * @param defaultValue Значение по умолчанию
-     * @return Ссылка на себя для цепочки вызовов
-     */
-    ArgParser::ArgBuilder& ArgParser::ArgBuilder::Default(bool defaultValue) {
-        auto& opt = parser_.options_[index_];
-        opt.hasDefault = true;
-        opt.defaultBool = defaultValue;
-        return *this;
-    }
-
-    /**
-     * @brief Указывает переменную для сохранения строкового значения
-     * @param out Ссылка на переменную для сохранения
-     * @return Ссылка на себя для цепочки вызовов
-     */
-    ArgParser::ArgBuilder& ArgParser::ArgBuilder::StoreValue(std::string& out) {
-        parser_.options_[index_].storeString = &out;
-        return *this;
-    }
-
-    /**
-     * @brief Указывает вектор для сохранения нескольких строковых значений
-     * @param out Ссылка на вектор для сохранения
-     * @return Ссылка на себя для цепочки вызовов
-     */
-    ArgParser::ArgBuilder& ArgParser::ArgBuilder::StoreValues(std::vector<std::string>& out) {
-        parser_.options_[index_].storeStrings = &out;
-        return *this;
-    }
-
-    /**
-     * @brief Указывает переменную для сохранения целочисленного значения
-     * @param out Ссылка на переменную для сохранения
-     * @return Ссылка на себя для цепочки вызовов
-     */
-    ArgParser::ArgBuilder& ArgParser::ArgBuilder::StoreValue(int& out) {
-        parser_.options_[index_].storeInt = &out;
-        return *this;
-    }
-
-    /**
-     * @brief Указывает вектор для сохранения нескольких целочисленных значений
-     * @param out Ссылка на вектор для сохранения
-     * @return Ссылка на себя для цепочки вызовов
-     */
-    ArgParser::ArgBuilder& ArgParser::ArgBuilder::StoreValues(std::vector<int>& out) {
-        parser_.options_[index_].storeInts = &out;
-        return *this;
-    }
-
-    /**
-     * @brief Указывает переменную для сохранения булева значения
-     * @param out Ссылка на переменную для сохранения
-     * @return Ссылка на себя для цепочки вызовов
-     */
-    ArgParser::ArgBuilder& ArgParser::ArgBuilder::StoreValue(bool& out) {
-        parser_.options_[index_].storeBool = &out;
-        return *this;
-    }
-
-    /**
-     * @brief Указывает, что опция может принимать несколько значений
-     * @param minCount Минимальное количество значений
-     * @return Ссылка на себя для цепочки вызовов
-     */
-    ArgParser::ArgBuilder& ArgParser::ArgBuilder::MultiValue(size_t minCount) {
-        auto& opt = parser_.options_[index_];
-        opt.multi = true;
-        opt.minCount = minCount;
-        return *this;
-    }
-
-    /**
-     * @brief Помечает опцию как позиционную
-     * @return Ссылка на себя для цепочки вызовов
-     */
-    ArgParser::ArgBuilder& ArgParser::ArgBuilder::Positional() {
-        parser_.options_[index_].positional = true;
-        return *this;
-    }
-
     // Методы добавления аргументов
 
     /**
@@ -161,9 +39,9 @@ namespace ArgumentParser {
      * @param description Описание аргумента
      * @return Построитель аргументов для настройки
      */
-    ArgParser::ArgBuilder ArgParser::AddStringArgument(const std::string& name, const std::string& description) {
+    ArgParser::ArgBuilder<std::string> ArgParser::AddStringArgument(const std::string& name, const std::string& description) {
         CreateOption(ArgType::String, 0, name, description);
-        return ArgBuilder(*this, options_.size() - 1);
+        return {*this, options_.size() - 1};
     }
 
     /**
@@ -173,9 +51,9 @@ namespace ArgumentParser {
      * @param description Описание аргумента
      * @return Построитель аргументов для настройки
      */
-    ArgParser::ArgBuilder ArgParser::AddStringArgument(char shortName, const std::string& name, const std::string& description) {
+    ArgParser::ArgBuilder<std::string> ArgParser::AddStringArgument(char shortName, const std::string& name, const std::string& description) {
         CreateOption(ArgType::String, shortName, name, description);
-        return ArgBuilder(*this, options_.size() - 1);
+        return {*this, options_.size() - 1};
     }
 
     /**
@@ -184,9 +62,9 @@ namespace ArgumentParser {
      * @param description Описание аргумента
      * @return Построитель аргументов для настройки
      */
-    ArgParser::ArgBuilder ArgParser::AddIntArgument(const std::string& name, const std::string& description) {
+    ArgParser::ArgBuilder<int> ArgParser::AddIntArgument(const std::string& name, const std::string& description) {
         CreateOption(ArgType::Int, 0, name, description);
-        return ArgBuilder(*this, options_.size() - 1);
+        return {*this, options_.size() - 1};
     }
 
     /**
@@ -196,9 +74,9 @@ namespace ArgumentParser {
      * @param description Описание аргумента
      * @return Построитель аргументов для настройки
      */
-    ArgParser::ArgBuilder ArgParser::AddIntArgument(char shortName, const std::string& name, const std::string& description) {
+    ArgParser::ArgBuilder<int> ArgParser::AddIntArgument(char shortName, const std::string& name, const std::string& description) {
         CreateOption(ArgType::Int, shortName, name, description);
-        return ArgBuilder(*this, options_.size() - 1);
+        return {*this, options_.size() - 1};
     }
 
     /**
@@ -207,9 +85,9 @@ namespace ArgumentParser {
      * @param description Описание флага
      * @return Построитель аргументов для настройки
      */
-    ArgParser::ArgBuilder ArgParser::AddFlag(const std::string& name, const std::string& description) {
+    ArgParser::ArgBuilder<bool> ArgParser::AddFlag(const std::string& name, const std::string& description) {
         CreateOption(ArgType::Flag, 0, name, description);
-        return ArgBuilder(*this, options_.size() - 1);
+        return {*this, options_.size() - 1};
     }
 
     /**
@@ -219,9 +97,9 @@ namespace ArgumentParser {
      * @param description Описание флага
      * @return Построитель аргументов для настройки
      */
-    ArgParser::ArgBuilder ArgParser::AddFlag(char shortName, const std::string& name, const std::string& description) {
+    ArgParser::ArgBuilder<bool> ArgParser::AddFlag(char shortName, const std::string& name, const std::string& description) {
         CreateOption(ArgType::Flag, shortName, name, description);
-        return ArgBuilder(*this, options_.size() - 1);
+        return {*this, options_.size() - 1};
     }
 
     /**
@@ -231,123 +109,256 @@ namespace ArgumentParser {
      * @param description Описание опции
      * @return Построитель аргументов для настройки
      */
-    ArgParser::ArgBuilder ArgParser::AddHelp(char shortName, const std::string& name, const std::string& description) {
+    ArgParser::ArgBuilder<bool> ArgParser::AddHelp(char shortName, const std::string& name, const std::string& description) {
         CreateOption(ArgType::Help, shortName, name, description);
-        return ArgBuilder(*this, options_.size() - 1);
+        return {*this, options_.size() - 1};
     }
 
     // Реализация парсинга
 
     /**
-     * @brief Парсит аргументы командной строки
-     * @param args Вектор строк аргументов
-     * @return true, если парсинг успешен, false в случае ошибки
+     * @brief Связывает схему парсера и ParseResult с detail::ParseArgument
      */
-    bool ArgParser::Parse(const std::vector<std::string>& args) {
-        // Сброс состояния всех опций
-        for (auto& opt : options_) {
-            opt.seen = false;
-            opt.valuesString.clear();
-            opt.valuesInt.clear();
+    struct ArgParser::Binding {
+        const ArgParser& parser;
+        ParseResult& result;
+        bool persistent;
+        // Передавать значения приёмникам OnValue/MoveValues (только неконстантный Parse)
+        bool streaming;
+
+        int FindLong(std::string_view name) const {
+            auto it = parser.longNameMap_.find(name);
+            return it == parser.longNameMap_.end() ? -1 : static_cast<int>(it->second);
         }
-        helpRequested_ = false;
 
-        // Поиск позиционной опции
-        Option* positionalOpt = nullptr;
-        for (auto& opt : options_) if (opt.positional) { positionalOpt = &opt; break; }
+        int FindShort(char name) const {
+            auto it = parser.shortNameMap_.find(name);
+            return it == parser.shortNameMap_.end() ? -1 : static_cast<int>(it->second);
+        }
 
-        // Обработка каждого аргумента
-        for (size_t i = 1; i < args.size(); ++i) {
-            const auto& arg = args[i];
-            if (arg.rfind("--", 0) == 0) {
-                // Обработка длинных опций (--option)
-                if (arg == "--help") {
-                    helpRequested_ = true;
-                    continue;
-                }
-                auto posEq = arg.find('=');
-                std::string name = arg.substr(2, posEq - 2);
-                if (!longNameMap_.count(name)) return false;
-                Option* opt = &options_[longNameMap_[name]];
-                if (opt->type == ArgType::Flag) { opt->valueBool = true; opt->seen = true; }
-                else {
-                    if (posEq == std::string::npos) return false;
-                    std::string val = arg.substr(posEq + 1);
-                    if (opt->type == ArgType::String) { if (opt->multi) opt->valuesString.push_back(val); else opt->valueString = val; }
-                    else if (opt->type == ArgType::Int) { try { int v = std::stoi(val); if (opt->multi) opt->valuesInt.push_back(v); else opt->valueInt = v; } catch (...) { return false; } }
-                    opt->seen = true;
-                }
+        int PositionalIndex() const {
+            return parser.positional_;
+        }
+
+        ArgType TypeOf(int idx) const {
+            return parser.options_[idx].type;
+        }
+
+        /**
+         * @brief Сохраняет значение строкового или целочисленного аргумента
+         * @param idx Индекс опции
+         * @param val Значение (представление внутри исходного аргумента)
+         * @return false, если значение не подходит по типу
+         */
+        bool Value(int idx, std::string_view val) {
+            const Option& opt = parser.options_[idx];
+            ParseResult::Slot& slot = result.slots_[idx];
+            if (opt.type == ArgType::Flag || opt.type == ArgType::Help) return false;
+            if (streaming && opt.sink >= 0) {
+                ConvertError err = parser.sinks_[opt.sink].onValue(val);
+                if (err != ConvertError::Ok) { result.lastError_ = err; return false; }
             }
-            else if (arg.rfind("-", 0) == 0) {
-                // Обработка коротких опций (-o)
-                if (arg.size() == 2 && arg[1] == 'h') { helpRequested_ = true; continue; }
-                if (arg.size() > 2 && arg[2] == '=') {
-                    char sn = arg[1];
-                    if (!shortNameMap_.count(sn)) return false;
-                    Option* opt = &options_[shortNameMap_[sn]];
-                    std::string val = arg.substr(3);
-                    if (opt->type == ArgType::String) { if (opt->multi) opt->valuesString.push_back(val); else opt->valueString = val; }
-                    else if (opt->type == ArgType::Int) { try { int v = std::stoi(val); if (opt->multi) opt->valuesInt.push_back(v); else opt->valueInt = v; } catch (...) { return false; } }
-                    else return false;
-                    opt->seen = true;
-                }
-                else {
-                    for (size_t k = 1; k < arg.size(); ++k) {
-                        char sn = arg[k];
-                        if (!shortNameMap_.count(sn)) return false;
-                        Option* opt = &options_[shortNameMap_[sn]];
-                        if (opt->type == ArgType::Flag) { opt->valueBool = true; opt->seen = true; }
-                        else return false;
-                    }
+            else if (opt.type == ArgType::Custom) {
+                // Текст не хранится: значение сразу преобразуется в T
+                ConvertError err = opt.hooks->convert(val, std::get<std::any>(slot.value), opt.multi, slot.count == 0);
+                if (err != ConvertError::Ok) { result.lastError_ = err; return false; }
+            }
+            else if (opt.type == ArgType::String) {
+                if (!persistent) val = result.ownedValues_.emplace_back(val);
+                if (opt.multi) std::get<std::vector<std::string_view>>(slot.value).push_back(val);
+                else std::get<std::string_view>(slot.value) = val;
+            }
+            else if (opt.type == ArgType::Int) {
+                int v = 0;
+                ConvertError err = ParseValue(val, v);
+                if (err != ConvertError::Ok) { result.lastError_ = err; return false; }
+                if (opt.multi) std::get<std::vector<int>>(slot.value).push_back(v);
+                else std::get<int>(slot.value) = v;
+            }
+            slot.seen = true;
+            ++slot.count;
+            return true;
+        }
+
+        void Flag(int idx) {
+            std::get<bool>(result.slots_[idx].value) = true;
+            result.slots_[idx].seen = true;
+        }
+
+        void Help() {
+            result.helpRequested_ = true;
+        }
+    };
+
+    /**
+     * @brief Разбирает аргументы из файла ответов
+     *
+     * Файл отображается в память и разбирается на месте: аргументы передаются
+     * в detail::ParseArgument по одному, без промежуточного списка строк.
+     * Вложенные @path раскрываются до глубины 8.
+     * @param path Путь к файлу (без '@')
+     * @param binding Приёмник; значения ссылаются на отображение и не копируются
+     * @param depth Глубина вложенности
+     * @return false, если файл не открылся, кавычка не закрыта или аргумент ошибочен
+     */
+    bool ArgParser::ParseResponseFile(std::string_view path, Binding& binding, int depth) const {
+        if (depth >= 8) return false;
+        ResponseFile& file = binding.result.responseFiles_.emplace_back();
+        if (!file.Open(std::string(path))) return false;
+        std::string_view token;
+        while (file.Next(token)) {
+            if (token.size() > 1 && token[0] == '@') {
+                if (!ParseResponseFile(token.substr(1), binding, depth + 1)) return false;
+            }
+            else if (!detail::ParseArgument(binding, binding, token)) return false;
+        }
+        return !file.Failed();
+    }
+
+    /**
+     * @brief Разбирает аргументы без копирования: имена и значения остаются представлениями
+     *
+     * Парсер только читается, всё состояние разбора пишется в result, поэтому
+     * один парсер можно использовать из нескольких потоков с разными ParseResult.
+     * Приёмники пользователя вызываются только при streaming, иначе их значения остаются в result.
+     * @param args Массив аргументов (первый — имя программы)
+     * @param count Количество аргументов
+     * @param persistent Живут ли аргументы дольше результата (argv); иначе строковые значения копируются
+     * @param streaming Вызывать ли приёмники OnValue/MoveValues
+     * @param result Результат разбора; буферы прошлого разбора переиспользуются
+     * @return true, если парсинг успешен, false в случае ошибки
+     */
+    bool ArgParser::ParseArgs(const std::string_view* args, size_t count, bool persistent, bool streaming, ParseResult& result) const {
+        result.Reset(*this);
+        if (streaming) {
+            for (const auto& sink : sinks_) {
+                if (sink.reset) sink.reset();
+            }
+        }
+
+        // Обработка каждого аргумента
+        Binding binding{*this, result, persistent, streaming};
+        Binding mapped{*this, result, true, streaming};
+        for (size_t i = 1; i < count; ++i) {
+            if (!subcommandMap_.empty() && !args[i].empty() && args[i][0] != '-' && args[i][0] != '@') {
+                auto it = subcommandMap_.find(args[i]);
+                if (it != subcommandMap_.end()) {
+                    // Остальные аргументы разбирает подкоманда (см. ParseInto)
+                    result.subcommand_ = static_cast<int>(it->second);
+                    result.subcommandArg_ = i;
+                    break;
                 }
             }
-            else {
-                // Обработка позиционного аргумента
-                if (!positionalOpt) return false;
-                Option* opt = positionalOpt;
-                if (opt->type == ArgType::String) { if (opt->multi) opt->valuesString.push_back(arg); else opt->valueString = arg; }
-                else if (opt->type == ArgType::Int) { try { int v = std::stoi(arg); if (opt->multi) opt->valuesInt.push_back(v); else opt->valueInt = v; } catch (...) { return false; } }
-                else return false;
-                opt->seen = true;
+            if (args[i].size() > 1 && args[i][0] == '@') {
+                if (!ParseResponseFile(args[i].substr(1), mapped, 0)) return false;
             }
+            else if (!detail::ParseArgument(binding, binding, args[i])) return false;
         }
 
         // Если запрошена справка, остальные проверки не нужны
-        if (helpRequested_) return true;
+        if (result.helpRequested_) return true;
 
         // Проверка обязательных аргументов и применение значений по умолчанию
-        for (auto& opt : options_) {
-            if (opt.type == ArgType::String) {
-                if (!opt.multi) {
-                    if (!opt.seen) {
-                        if (opt.hasDefault) opt.valueString = opt.defaultString;
-                        else return false;
-                    }
-                }
-                else if (opt.valuesString.size() < opt.minCount) return false;
-                if (opt.storeString) *opt.storeString = opt.valueString;
-                if (opt.storeStrings) *opt.storeStrings = opt.valuesString;
+        for (size_t i = 0; i < options_.size(); ++i) {
+            const Option& opt = options_[i];
+            ParseResult::Slot& slot = result.slots_[i];
+            if (opt.type == ArgType::Help || (slot.seen && !opt.multi)) continue;
+            if (opt.multi) {
+                if (slot.count < opt.minCount) return false;
             }
-            else if (opt.type == ArgType::Int) {
-                if (!opt.multi) {
-                    if (!opt.seen) {
-                        if (opt.hasDefault) opt.valueInt = opt.defaultInt;
-                        else return false;
-                    }
-                }
-                else if (opt.valuesInt.size() < opt.minCount) return false;
-                if (opt.storeInt) *opt.storeInt = opt.valueInt;
-                if (opt.storeInts) *opt.storeInts = opt.valuesInt;
+            else if (opt.type == ArgType::Custom) {
+                // Значение по умолчанию уже преобразовано в Default()
+                if (!std::holds_alternative<std::any>(opt.defaultValue)) return false;
+            }
+            else if (auto* text = std::get_if<std::string>(&opt.defaultValue)) {
+                std::get<std::string_view>(slot.value) = *text;
             }
-            else if (opt.type == ArgType::Flag) {
-                if (!opt.seen && opt.hasDefault) opt.valueBool = opt.defaultBool;
-                if (opt.storeBool) *opt.storeBool = opt.valueBool;
+            else if (auto* number = std::get_if<int>(&opt.defaultValue)) {
+                std::get<int>(slot.value) = *number;
             }
+            else if (auto* flag = std::get_if<bool>(&opt.defaultValue)) {
+                std::get<bool>(slot.value) = *flag;
+            }
+            else if (opt.type != ArgType::Flag) return false;
         }
 
         return true;
     }
 
+    /**
+     * @brief Записывает результат внутреннего разбора в переменные StoreValue/StoreValues
+     *
+     * Строки материализуются только для привязанных переменных.
+     * @return false, если значение не преобразуется к типу переменной
+     */
+    bool ArgParser::ApplyStores() {
+        for (size_t i = 0; i < options_.size(); ++i) {
+            const Option& opt = options_[i];
+            if (!opt.store) continue;
+            ConvertError err = opt.hooks->store(result_.slots_[i], opt, opt.store);
+            if (err != ConvertError::Ok) {
+                result_.lastError_ = err;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Строит подкоманду при первом обращении
+     * @param index Индекс подкоманды
+     * @return Парсер подкоманды
+     */
+    ArgParser& ArgParser::BuildSubcommand(size_t index) const {
+        SubcommandEntry& entry = *subcommands_[index];
+        std::call_once(entry.built, [&entry] {
+            entry.parser = std::make_unique<ArgParser>(entry.name);
+            entry.factory(*entry.parser);
+        });
+        return *entry.parser;
+    }
+
+    /**
+     * @brief Разбирает аргументы в результат, передавая хвост выбранной подкоманде
+     * @param args Массив аргументов (первый — имя программы или подкоманды)
+     * @param count Количество аргументов
+     * @param persistent Живут ли аргументы дольше результата
+     * @param result Результат разбора
+     * @return true, если парсинг успешен, false в случае ошибки
+     */
+    bool ArgParser::ParseInto(const std::string_view* args, size_t count, bool persistent, ParseResult& result) const {
+        if (!ParseArgs(args, count, persistent, false, result)) return false;
+        if (result.helpRequested_ || result.subcommand_ < 0) return true;
+        if (!result.subResult_) result.subResult_ = std::make_unique<ParseResult>();
+        size_t pos = result.subcommandArg_;
+        return BuildSubcommand(result.subcommand_).ParseInto(args + pos, count - pos, persistent, *result.subResult_);
+    }
+
+    /**
+     * @brief Разбирает аргументы во внутренний результат и заполняет переменные StoreValue
+     *
+     * Выбранная подкоманда разбирает свой хвост так же, в собственный внутренний результат.
+     * @return true, если парсинг успешен, false в случае ошибки
+     */
+    bool ArgParser::ParseAndStore(const std::string_view* args, size_t count, bool persistent) {
+        if (!ParseArgs(args, count, persistent, true, result_)) return false;
+        if (result_.helpRequested_) return true;
+        if (!ApplyStores()) return false;
+        if (result_.subcommand_ < 0) return true;
+        size_t pos = result_.subcommandArg_;
+        return BuildSubcommand(result_.subcommand_).ParseAndStore(args + pos, count - pos, persistent);
+    }
+
+    /**
+     * @brief Парсит аргументы командной строки
+     * @param args Вектор строк аргументов
+     * @return true, если парсинг успешен, false в случае ошибки
+     */
+    bool ArgParser::Parse(const std::vector<std::string>& args) {
+        std::vector<std::string_view> views(args.begin(), args.end());
+        return ParseAndStore(views.data(), views.size(), false);
+    }
+
     /**
      * @brief Парсит аргументы командной строки (C-style)
      * @param argc Количество аргументов
@@ -355,8 +366,66 @@ namespace ArgumentParser {
      * @return true, если парсинг успешен, false в случае ошибки
      */
     bool ArgParser::Parse(int argc, char** argv) {
-        std::vector<std::string> args(argv, argv + argc);
-        return Parse(args);
+        std::vector<std::string_view> views(argv, argv + argc);
+        return ParseAndStore(views.data(), views.size(), true);
+    }
+
+    /**
+     * @brief Парсит аргументы в отдельный результат, не изменяя парсер
+     *
+     * Единственное изменение — построение ещё не созданной подкоманды, оно защищено call_once.
+     * Приёмники OnValue/MoveValues не вызываются: их значения доступны через result.
+     * @param args Вектор строк аргументов
+     * @param result Результат разбора
+     * @return true, если парсинг успешен, false в случае ошибки
+     */
+    bool ArgParser::Parse(const std::vector<std::string>& args, ParseResult& result) const {
+        std::vector<std::string_view> views(args.begin(), args.end());
+        return ParseInto(views.data(), views.size(), false, result);
+    }
+
+    /**
+     * @brief Парсит argc/argv в отдельный результат, не изменяя парсер
+     * @param argc Количество аргументов
+     * @param argv Массив строк аргументов
+     * @param result Результат разбора
+     * @return true, если парсинг успешен, false в случае ошибки
+     */
+    bool ArgParser::Parse(int argc, char** argv, ParseResult& result) const {
+        std::vector<std::string_view> views(argv, argv + argc);
+        return ParseInto(views.data(), views.size(), true, result);
+    }
+
+    /**
+     * @brief Регистрирует подкоманду, опции которой создаются лениво
+     * @param name Имя подкоманды
+     * @param description Описание для справки
+     * @param factory Функция, добавляющая опции в парсер подкоманды
+     */
+    void ArgParser::AddSubcommand(const std::string& name, const std::string& description,
+                                  std::function<void(ArgParser&)> factory) {
+        auto entry = std::make_unique<SubcommandEntry>();
+        entry->name = name;
+        entry->description = description;
+        entry->factory = std::move(factory);
+        subcommandMap_[name] = subcommands_.size();
+        subcommands_.push_back(std::move(entry));
+    }
+
+    /**
+     * @brief Возвращает подкоманду, выбранную последним Parse(args)
+     * @return Имя подкоманды или пустая строка
+     */
+    std::string_view ArgParser::Subcommand() const {
+        return result_.Subcommand();
+    }
+
+    /**
+     * @brief Возвращает парсер подкоманды, выбранной последним Parse(args)
+     * @return Парсер подкоманды со значениями её аргументов или nullptr
+     */
+    ArgParser* ArgParser::SubcommandParser() const {
+        return result_.subcommand_ < 0 ? nullptr : subcommands_[result_.subcommand_]->parser.get();
     }
 
     /**
@@ -364,7 +433,7 @@ namespace ArgumentParser {
      * @return true, если запрошена справка
      */
     bool ArgParser::Help() const {
-        return helpRequested_;
+        return result_.Help();
     }
 
     /**
@@ -377,18 +446,148 @@ namespace ArgumentParser {
         return oss.str();
     }
 
+    /**
+     * @brief Возвращает ошибку последнего неудачного преобразования значения
+     * @return ConvertError::Ok, если ошибка не связана с преобразованием
+     */
+    ConvertError ArgParser::LastError() const {
+        return result_.LastError();
+    }
+
+    std::string ArgParser::GetStringValue(const std::string& name) const {
+        return result_.GetStringValue(name);
+    }
+
+    int ArgParser::GetIntValue(const std::string& name) const {
+        return result_.GetIntValue(name);
+    }
+
+    int ArgParser::GetIntValue(const std::string& name, size_t index) const {
+        return result_.GetIntValue(name, index);
+    }
+
+    bool ArgParser::GetFlag(const std::string& name) const {
+        return result_.GetFlag(name);
+    }
+
+    // Реализация ParseResult
+
+    /**
+     * @brief Готовит результат к новому разбору, сохраняя выделенную память
+     * @param parser Схема, по которой идёт разбор
+     */
+    void ParseResult::Reset(const ArgParser& parser) {
+        if (parser_ != &parser) slots_.clear();
+        parser_ = &parser;
+        slots_.resize(parser.options_.size());
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            Slot& slot = slots_[i];
+            slot.seen = false;
+            slot.count = 0;
+            if (std::holds_alternative<std::monostate>(slot.value)) {
+                const auto& opt = parser.options_[i];
+                if (opt.type == ArgType::Int) {
+                    if (opt.multi) slot.value = std::vector<int>(); else slot.value = 0;
+                }
+                else if (opt.type == ArgType::String) {
+                    if (opt.multi) slot.value = std::vector<std::string_view>(); else slot.value = std::string_view();
+                }
+                else if (opt.type == ArgType::Custom) slot.value = std::any();
+                else slot.value = false;
+                continue;
+            }
+            // Тип значения уже выбран: векторы очищаются без освобождения памяти,
+            // значение AddArgument<T> перезаписывается при разборе (count == 0 — его нет)
+            std::visit([](auto& v) {
+                using V = std::decay_t<decltype(v)>;
+                if constexpr (std::is_same_v<V, std::vector<int>> || std::is_same_v<V, std::vector<std::string_view>>) v.clear();
+                else if constexpr (!std::is_same_v<V, std::any>) v = V();
+            }, slot.value);
+        }
+        ownedValues_.clear();
+        responseFiles_.clear();
+        subcommand_ = -1;
+        subcommandArg_ = 0;
+        helpRequested_ = false;
+        lastError_ = ConvertError::Ok;
+    }
+
+    /**
+     * @brief Ищет состояние опции по длинному имени
+     * @param name Имя аргумента
+     * @return Указатель на состояние или nullptr, если опции нет
+     */
+    const ParseResult::Slot* ParseResult::Find(const std::string& name) const {
+        if (!parser_) return nullptr;
+        auto it = parser_->longNameMap_.find(name);
+        return it == parser_->longNameMap_.end() ? nullptr : &slots_[it->second];
+    }
+
+    /**
+     * @brief Возвращает текст значения строковой опции с учётом значения по умолчанию
+     * @param name Имя аргумента
+     * @param out Текст значения (первое значение для multi-value)
+     * @return ConvertError::Empty, если значения нет
+     */
+    ConvertError ParseResult::TextValue(const std::string& name, std::string_view& out) const {
+        const Slot* slot = Find(name);
+        if (!slot) return ConvertError::Empty;
+        const auto& opt = parser_->options_[slot - slots_.data()];
+        if (auto* values = std::get_if<std::vector<std::string_view>>(&slot->value)) {
+            if (values->empty()) return ConvertError::Empty;
+            out = values->front();
+        }
+        else if (slot->seen) {
+            // У AddArgument<T> текста нет — только преобразованное значение
+            auto* text = std::get_if<std::string_view>(&slot->value);
+            if (!text) return ConvertError::Empty;
+            out = *text;
+        }
+        else if (auto* text = std::get_if<std::string>(&opt.defaultValue)) out = *text;
+        else return ConvertError::Empty;
+        return ConvertError::Ok;
+    }
+
+    /**
+     * @brief Возвращает выбранную подкоманду
+     * @return Имя подкоманды или пустая строка
+     */
+    std::string_view ParseResult::Subcommand() const {
+        return subcommand_ < 0 ? std::string_view() : std::string_view(parser_->subcommands_[subcommand_]->name);
+    }
+
+    /**
+     * @brief Возвращает результат разбора аргументов выбранной подкоманды
+     * @return Результат или nullptr, если подкоманда не выбрана
+     */
+    const ParseResult* ParseResult::SubcommandResult() const {
+        return subcommand_ < 0 ? nullptr : subResult_.get();
+    }
+
+    /**
+     * @brief Проверяет, был ли запрошен вывод справки
+     * @return true, если запрошена справка
+     */
+    bool ParseResult::Help() const {
+        return helpRequested_;
+    }
+
+    /**
+     * @brief Возвращает ошибку последнего неудачного преобразования значения
+     * @return ConvertError::Ok, если ошибка не связана с преобразованием
+     */
+    ConvertError ParseResult::LastError() const {
+        return lastError_;
+    }
+
     /**
      * @brief Получает строковое значение аргумента
      * @param name Имя аргумента
      * @return Значение аргумента или пустая строка, если не найден
      */
-    std::string ArgParser::GetStringValue(const std::string& name) const {
-        auto it = longNameMap_.find(name);
-        if (it == longNameMap_.end()) return {};
-        const Option& opt = options_[it->second];
-        if (!opt.multi && !opt.seen && opt.hasDefault) return opt.defaultString;
-        if (opt.multi) return opt.valuesString.empty() ? std::string() : opt.valuesString[0];
-        return opt.valueString;
+    std::string ParseResult::GetStringValue(const std::string& name) const {
+        std::string_view text;
+        return TextValue(name, text) == ConvertError::Ok ? std::string(text) : std::string();
     }
 
     /**
@@ -396,13 +595,14 @@ namespace ArgumentParser {
      * @param name Имя аргумента
      * @return Значение аргумента или 0, если не найден
      */
-    int ArgParser::GetIntValue(const std::string& name) const {
-        auto it = longNameMap_.find(name);
-        if (it == longNameMap_.end()) return 0;
-        const Option& opt = options_[it->second];
-        if (!opt.multi && !opt.seen && opt.hasDefault) return opt.defaultInt;
-        if (opt.multi) return opt.valuesInt.empty() ? 0 : opt.valuesInt[0];
-        return opt.valueInt;
+    int ParseResult::GetIntValue(const std::string& name) const {
+        const Slot* slot = Find(name);
+        if (!slot) return 0;
+        const auto& opt = parser_->options_[slot - slots_.data()];
+        if (auto* values = std::get_if<std::vector<int>>(&slot->value)) return values->empty() ? 0 : values->front();
+        if (!slot->seen && std::holds_alternative<int>(opt.defaultValue)) return std::get<int>(opt.defaultValue);
+        auto* value = std::get_if<int>(&slot->value);
+        return value ? *value : 0;
     }
 
     /**
@@ -411,11 +611,10 @@ namespace ArgumentParser {
      * @param index Индекс значения
      * @return Значение аргумента или 0, если не найден
      */
-    int ArgParser::GetIntValue(const std::string& name, size_t index) const {
-        auto it = longNameMap_.find(name);
-        if (it == longNameMap_.end()) return 0;
-        const Option& opt = options_[it->second];
-        return (opt.multi && index < opt.valuesInt.size()) ? opt.valuesInt[index] : 0;
+    int ParseResult::GetIntValue(const std::string& name, size_t index) const {
+        const Slot* slot = Find(name);
+        auto* values = slot ? std::get_if<std::vector<int>>(&slot->value) : nullptr;
+        return (values && index < values->size()) ? (*values)[index] : 0;
     }
 
     /**
@@ -423,11 +622,13 @@ namespace ArgumentParser {
      * @param name Имя флага
      * @return true, если флаг установлен или есть значение по умолчанию
      */
-    bool ArgParser::GetFlag(const std::string& name) const {
-        auto it = longNameMap_.find(name);
-        if (it == longNameMap_.end()) return false;
-        const Option& opt = options_[it->second];
-        return opt.seen ? opt.valueBool : (opt.hasDefault ? opt.defaultBool : false);
+    bool ParseResult::GetFlag(const std::string& name) const {
+        const Slot* slot = Find(name);
+        if (!slot) return false;
+        const auto& opt = parser_->options_[slot - slots_.data()];
+        if (!slot->seen) return std::holds_alternative<bool>(opt.defaultValue) && std::get<bool>(opt.defaultValue);
+        auto* value = std::get_if<bool>(&slot->value);
+        return value && *value;
     }
 
 } // namespace ArgumentParser
@@ -1,105 +1,546 @@
 // ArgParser.h
 #pragma once
 
+#include "ParseCore.h"
+#include "ResponseFile.h"
+
+#include <any>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include <unordered_map>
+#include <variant>
 
 namespace ArgumentParser {
 
+class ArgParser;
+
+// Typed reference to an option: values are read by index, without a name lookup.
+// Obtained from the builder returned by Add*Argument; remembers its parser, so a
+// default-constructed handle or one from another parser reads as "no value"
+template <class T>
+class OptionHandle {
+public:
+    OptionHandle() = default;
+    size_t Index() const { return index_; }
+
+private:
+    friend class ArgParser;
+    friend class ParseResult;
+    OptionHandle(const ArgParser* parser, size_t index) : parser_(parser), index_(index) {}
+    const ArgParser* parser_ = nullptr;
+    size_t index_ = static_cast<size_t>(-1);
+};
+
+// Result of one ArgParser::Parse call; reusable across calls to keep its buffers.
+// Values may reference argv, the parser's defaults and mapped response files:
+// the parser must outlive the result.
+class ParseResult {
+public:
+    bool Help() const;
+    ConvertError LastError() const;
+
+    std::string GetStringValue(const std::string& name) const;
+    int GetIntValue(const std::string& name) const;
+    int GetIntValue(const std::string& name, size_t index) const;
+    bool GetFlag(const std::string& name) const;
+
+    template <class T>
+    ConvertError GetValue(const std::string& name, T& out) const;
+    template <class T>
+    ConvertError GetValues(const std::string& name, std::vector<T>& out) const;
+
+    // Direct access by handle: std::string_view for string options, int, bool, T for AddArgument<T>.
+    // Empty value (0, "", false, T{}) if there is no value or the handle is not from this result's parser
+    template <class T>
+    auto Get(OptionHandle<T> option) const;
+    // i-th value of a multi-value option
+    template <class T>
+    auto Get(OptionHandle<T> option, size_t index) const;
+    template <class T>
+    size_t Count(OptionHandle<T> option) const;
+
+    // Selected subcommand ("" if none) and the result of parsing its arguments
+    std::string_view Subcommand() const;
+    const ParseResult* SubcommandResult() const;
+
+private:
+    friend class ArgParser;
+
+    // Значение опции: string_view, int или bool для одиночных, вектор для multi-value;
+    // у AddArgument<T> — std::any с T (std::vector<T> для multi-value), преобразованным при разборе.
+    // Альтернатива выбирается по типу опции при первом Reset и дальше не меняется
+    using Value = std::variant<std::monostate, std::string_view, int, bool,
+                               std::vector<std::string_view>, std::vector<int>, std::any>;
+
+    // Разобранное состояние одной опции
+    struct Slot {
+        uint32_t count = 0;
+        bool seen = false;
+        Value value;
+    };
+#if defined(__GLIBCXX__) && defined(__x86_64__)
+    static_assert(sizeof(Value) == 32 && sizeof(Slot) == 40, "Slot layout changed");
+#endif
+
+    void Reset(const ArgParser& parser);
+    // Слот опции дескриптора или nullptr, если разбора не было или дескриптор от другого парсера
+    template <class T>
+    const Slot* SlotOf(OptionHandle<T> option) const;
+    // Преобразованное значение AddArgument<T> (первое для multi-value) или значение по умолчанию;
+    // nullptr, если значения нет или опция другого типа
+    template <class T>
+    const T* ConvertedValue(const Slot& slot) const;
+    const Slot* Find(const std::string& name) const;
+    ConvertError TextValue(const std::string& name, std::string_view& out) const;
+
+    const ArgParser* parser_ = nullptr;
+    std::vector<Slot> slots_;
+    bool helpRequested_ = false;
+    ConvertError lastError_ = ConvertError::Ok;
+    // Значения ссылаются на argv; при разборе временного вектора строк копируются сюда
+    std::deque<std::string> ownedValues_;
+    // Отображённые файлы ответов; значения из них ссылаются на отображение
+    std::deque<ResponseFile> responseFiles_;
+    // Выбранная подкоманда: индекс и позиция её имени в аргументах
+    int subcommand_ = -1;
+    size_t subcommandArg_ = 0;
+    std::unique_ptr<ParseResult> subResult_;
+};
+
 class ArgParser {
 public:
     ArgParser(const std::string& programName);
 
-    // Parse from argc/argv or a vector of strings
+    // Parse from argc/argv or a vector of strings; "@path" expands to the arguments in a response file
     bool Parse(int argc, char** argv);
     bool Parse(const std::vector<std::string>& args);
 
+    // Thread-safe parse: the parser is only read, StoreValue targets are not written and
+    // OnValue/MoveValues sinks are not called (their values stay in the result)
+    bool Parse(int argc, char** argv, ParseResult& result) const;
+    bool Parse(const std::vector<std::string>& args, ParseResult& result) const;
+
     // Check if help was requested
     bool Help() const;
 
     // Generate help description
     std::string HelpDescription() const;
 
+    // Error of the last failed value conversion
+    ConvertError LastError() const;
+
     // Retrieve parsed values
     std::string GetStringValue(const std::string& name) const;
     int GetIntValue(const std::string& name) const;
     int GetIntValue(const std::string& name, size_t index) const;
     bool GetFlag(const std::string& name) const;
 
-    // Builder for defining arguments
+    // Typed access through ValueConverter<T> (string and AddArgument<T> options)
+    template <class T>
+    ConvertError GetValue(const std::string& name, T& out) const;
+    template <class T>
+    ConvertError GetValues(const std::string& name, std::vector<T>& out) const;
+
+    // Direct access by handle to the values of the last Parse(args)
+    template <class T>
+    auto Get(OptionHandle<T> option) const { return result_.Get(option); }
+    template <class T>
+    auto Get(OptionHandle<T> option, size_t index) const { return result_.Get(option, index); }
+    template <class T>
+    size_t Count(OptionHandle<T> option) const { return result_.Count(option); }
+
+    // Builder for defining arguments; T is the value type of the option
+    template <class T>
     class ArgBuilder;
 
     // Add different kinds of arguments
-    ArgBuilder AddStringArgument(const std::string& name, const std::string& description = "");
-    ArgBuilder AddStringArgument(char shortName, const std::string& name, const std::string& description = "");
+    ArgBuilder<std::string> AddStringArgument(const std::string& name, const std::string& description = "");
+    ArgBuilder<std::string> AddStringArgument(char shortName, const std::string& name, const std::string& description = "");
 
-    ArgBuilder AddIntArgument(const std::string& name, const std::string& description = "");
-    ArgBuilder AddIntArgument(char shortName, const std::string& name, const std::string& description = "");
+    ArgBuilder<int> AddIntArgument(const std::string& name, const std::string& description = "");
+    ArgBuilder<int> AddIntArgument(char shortName, const std::string& name, const std::string& description = "");
 
-    ArgBuilder AddFlag(const std::string& name, const std::string& description = "");
-    ArgBuilder AddFlag(char shortName, const std::string& name, const std::string& description = "");
+    ArgBuilder<bool> AddFlag(const std::string& name, const std::string& description = "");
+    ArgBuilder<bool> AddFlag(char shortName, const std::string& name, const std::string& description = "");
 
-    ArgBuilder AddHelp(char shortName, const std::string& name, const std::string& description);
+    ArgBuilder<bool> AddHelp(char shortName, const std::string& name, const std::string& description);
+
+    // Argument of any type with a ValueConverter<T> (int64_t, uint64_t, double, Size, user types)
+    template <class T>
+    ArgBuilder<T> AddArgument(const std::string& name, const std::string& description = "");
+    template <class T>
+    ArgBuilder<T> AddArgument(char shortName, const std::string& name, const std::string& description = "");
+
+    // Subcommand: the first plain argument equal to name hands the remaining arguments
+    // to a child parser. The factory defines its options and runs only when the
+    // subcommand is selected for the first time
+    void AddSubcommand(const std::string& name, const std::string& description,
+                       std::function<void(ArgParser&)> factory);
+    // Subcommand selected by the last Parse(args) and its parser (nullptr if none)
+    std::string_view Subcommand() const;
+    ArgParser* SubcommandParser() const;
 
 private:
+    friend class ParseResult;
+
     std::string programName_;
-    bool helpRequested_ = false;
+    int positional_ = -1;
 
-    enum class ArgType { String, Int, Flag, Help };
+    struct Option;
+    // convert — проверка и сохранение T в Slot::value (только AddArgument<T>, detail::ConvertInto<T>);
+    // store — запись значения в цель StoreValue (Multi = false) или StoreValues (Multi = true)
+    struct Hooks {
+        ConvertError (*convert)(std::string_view, std::any&, bool, bool);
+        ConvertError (*store)(const ParseResult::Slot&, const Option&, void*);
+    };
+    template <class T, bool Multi>
+    static const Hooks* HooksFor();
+    // Значение AddArgument<T> из разбора или, если опции не было, из Default(); nullptr — значения нет
+    static const std::any* Payload(const ParseResult::Slot& slot, const Option& opt);
+
+    // Поля, нужные при разборе; имена и описания хранятся отдельно (longNameMap_, descriptions_)
     struct Option {
         ArgType type;
-        std::string longName;
-        char shortName;
-        std::string description;
+        char shortName = 0;
         bool positional = false;
         bool multi = false;
-        size_t minCount = 0;
-        bool seen = false;
-        bool hasDefault = false;
-        std::string defaultString;
-        int defaultInt = 0;
-        bool defaultBool = false;
-        std::string valueString;
-        std::vector<std::string> valuesString;
-        int valueInt = 0;
-        std::vector<int> valuesInt;
-        bool valueBool = false;
-        std::string* storeString = nullptr;
-        std::vector<std::string>* storeStrings = nullptr;
-        int* storeInt = nullptr;
-        std::vector<int>* storeInts = nullptr;
-        bool* storeBool = nullptr;
+        uint32_t minCount = 0;
+        int32_t sink = -1;
+        // Функции типа T, общие для всех опций этого типа (HooksFor<T, Multi>)
+        const Hooks* hooks = nullptr;
+        // Единственная цель StoreValue/StoreValues
+        void* store = nullptr;
+        // monostate — значения по умолчанию нет; для строковых — текст,
+        // для AddArgument<T> — std::any с T, преобразованным в Default()
+        std::variant<std::monostate, std::string, int, bool, std::any> defaultValue;
+    };
+#if defined(__GLIBCXX__) && defined(__x86_64__)
+    static_assert(sizeof(Option) == 72, "Option layout changed");
+#endif
+
+    // Потоковый приёмник: значение преобразуется и передаётся сразу, в ParseResult не хранится
+    struct Sink {
+        std::function<ConvertError(std::string_view)> onValue;
+        std::function<void()> reset;
     };
 
     std::vector<Option> options_;
-    std::unordered_map<std::string, size_t> longNameMap_;
+    std::vector<std::string> descriptions_;
+    std::vector<Sink> sinks_;
+
+    // Подкоманда строится фабрикой при первом выборе; call_once делает это безопасным для const Parse
+    struct SubcommandEntry {
+        std::string name;
+        std::string description;
+        std::function<void(ArgParser&)> factory;
+        std::once_flag built;
+        std::unique_ptr<ArgParser> parser;
+    };
+
+    std::vector<std::unique_ptr<SubcommandEntry>> subcommands_;
+    std::map<std::string, size_t, std::less<>> subcommandMap_;
+    std::map<std::string, size_t, std::less<>> longNameMap_;
     std::unordered_map<char, size_t> shortNameMap_;
+    // Результат вызовов Parse без явного ParseResult
+    ParseResult result_;
 
     Option& CreateOption(ArgType type, char shortName, const std::string& longName, const std::string& description);
+    bool ParseArgs(const std::string_view* args, size_t count, bool persistent, bool streaming, ParseResult& result) const;
+    bool ApplyStores();
+    bool ParseInto(const std::string_view* args, size_t count, bool persistent, ParseResult& result) const;
+    bool ParseAndStore(const std::string_view* args, size_t count, bool persistent);
+    ArgParser& BuildSubcommand(size_t index) const;
+
+    // Схема и приёмник для detail::ParseArgument
+    struct Binding;
+    bool ParseResponseFile(std::string_view path, Binding& binding, int depth) const;
 
 public:
+    template <class T>
     class ArgBuilder {
     public:
-        ArgBuilder(ArgParser& parser, size_t index);
+        ArgBuilder(ArgParser& parser, size_t index) : parser_(parser), index_(index) {}
+
+        // Text for string and AddArgument<T> options, int for int options, bool for flags.
+        // Throws std::invalid_argument if the text does not convert to T
+        template <class V>
+        ArgBuilder& Default(const V& defaultValue);
 
-        ArgBuilder& Default(const std::string& defaultValue);
-        ArgBuilder& Default(int defaultValue);
-        ArgBuilder& Default(bool defaultValue);
+        ArgBuilder& StoreValue(T& out);
+        ArgBuilder& StoreValues(std::vector<T>& out);
 
-        ArgBuilder& StoreValue(std::string& out);
-        ArgBuilder& StoreValues(std::vector<std::string>& out);
-        ArgBuilder& StoreValue(int& out);
-        ArgBuilder& StoreValues(std::vector<int>& out);
-        ArgBuilder& StoreValue(bool& out);
+        // Streaming: each value goes to callback(v) as soon as it is parsed and is not kept
+        // in the result (v is int, std::string_view for strings, T for AddArgument<T>).
+        // Only Parse(argc, argv) and Parse(args) stream; the const Parse(..., ParseResult&)
+        // stores the values in its result instead, so concurrent parses never share the sink
+        template <class F>
+        ArgBuilder& OnValue(F callback);
+        // Streaming into out: cleared at the start of the non-const Parse, values are appended as they are parsed
+        ArgBuilder& MoveValues(std::vector<T>& out);
 
         ArgBuilder& MultiValue(size_t minCount = 0);
         ArgBuilder& Positional();
 
+        OptionHandle<T> Handle() const { return OptionHandle<T>(&parser_, index_); }
+        operator OptionHandle<T>() const { return Handle(); }
+
     private:
         ArgParser& parser_;
         size_t index_;
     };
 };
 
-} // namespace ArgumentParser
\ No newline at end of file
+template <class T>
+ArgParser::ArgBuilder<T> ArgParser::AddArgument(const std::string& name, const std::string& description) {
+    return AddArgument<T>(0, name, description);
+}
+
+template <class T>
+ArgParser::ArgBuilder<T> ArgParser::AddArgument(char shortName, const std::string& name, const std::string& description) {
+    Option& opt = CreateOption(ArgType::Custom, shortName, name, description);
+    opt.hooks = HooksFor<T, false>();
+    return {*this, options_.size() - 1};
+}
+
+template <class T, bool Multi>
+const ArgParser::Hooks* ArgParser::HooksFor() {
+    static constexpr Hooks hooks{&detail::ConvertInto<T>, [](const ParseResult::Slot& slot, const Option& option, void* target) {
+        if constexpr (Multi) {
+            auto& out = *static_cast<std::vector<T>*>(target);
+            if constexpr (std::is_same_v<T, int>) {
+                if (auto* v = std::get_if<std::vector<int>>(&slot.value)) out = *v;
+            } else if constexpr (std::is_same_v<T, std::string>) {
+                if (auto* v = std::get_if<std::vector<std::string_view>>(&slot.value)) out.assign(v->begin(), v->end());
+            } else {
+                auto* v = slot.count ? std::any_cast<std::vector<T>>(std::get_if<std::any>(&slot.value)) : nullptr;
+                if (v) out = *v;
+                else out.clear();
+            }
+        } else if constexpr (std::is_same_v<T, int> || std::is_same_v<T, bool>) {
+            if (auto* v = std::get_if<T>(&slot.value)) *static_cast<T*>(target) = *v;
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            if (auto* v = std::get_if<std::string_view>(&slot.value)) static_cast<std::string*>(target)->assign(*v);
+        } else {
+            // Значение уже преобразовано при разборе или в Default()
+            if (auto* v = std::any_cast<T>(Payload(slot, option))) *static_cast<T*>(target) = *v;
+        }
+        return ConvertError::Ok;
+    }};
+    return &hooks;
+}
+
+inline const std::any* ArgParser::Payload(const ParseResult::Slot& slot, const Option& opt) {
+    return slot.seen ? std::get_if<std::any>(&slot.value) : std::get_if<std::any>(&opt.defaultValue);
+}
+
+template <class T>
+template <class V>
+ArgParser::ArgBuilder<T>& ArgParser::ArgBuilder<T>::Default(const V& defaultValue) {
+    Option& opt = parser_.options_[index_];
+    if constexpr (std::is_same_v<T, int>) {
+        static_assert(std::is_integral_v<V> && !std::is_same_v<V, bool>, "int option expects an int default");
+        opt.defaultValue = static_cast<int>(defaultValue);
+    } else if constexpr (std::is_same_v<T, bool>) {
+        static_assert(std::is_same_v<V, bool>, "flag expects a bool default");
+        opt.defaultValue = defaultValue;
+    } else {
+        static_assert(std::is_convertible_v<const V&, std::string_view>, "default value is given as text");
+        std::string text{std::string_view(defaultValue)};
+        if constexpr (std::is_same_v<T, std::string>) {
+            opt.defaultValue = std::move(text);
+        } else {
+            T value{};
+            if (ParseValue(text, value) != ConvertError::Ok) throw std::invalid_argument("invalid default value: " + text);
+            opt.defaultValue = std::any(std::move(value));
+        }
+    }
+    return *this;
+}
+
+template <class T>
+ArgParser::ArgBuilder<T>& ArgParser::ArgBuilder<T>::StoreValue(T& out) {
+    Option& opt = parser_.options_[index_];
+    opt.store = &out;
+    opt.hooks = HooksFor<T, false>();
+    return *this;
+}
+
+template <class T>
+ArgParser::ArgBuilder<T>& ArgParser::ArgBuilder<T>::StoreValues(std::vector<T>& out) {
+    static_assert(!std::is_same_v<T, bool>, "flags have no multiple values");
+    Option& opt = parser_.options_[index_];
+    opt.store = &out;
+    opt.hooks = HooksFor<T, true>();
+    return *this;
+}
+
+template <class T>
+template <class F>
+ArgParser::ArgBuilder<T>& ArgParser::ArgBuilder<T>::OnValue(F callback) {
+    static_assert(!std::is_same_v<T, bool>, "flags have no values");
+    parser_.options_[index_].sink = static_cast<int32_t>(parser_.sinks_.size());
+    parser_.sinks_.push_back({});
+    parser_.sinks_.back().onValue = [callback = std::move(callback)](std::string_view text) mutable {
+        if constexpr (std::is_same_v<T, std::string>) {
+            callback(text);
+            return ConvertError::Ok;
+        } else {
+            T value{};
+            ConvertError err = ParseValue(text, value);
+            if (err == ConvertError::Ok) callback(std::move(value));
+            return err;
+        }
+    };
+    return *this;
+}
+
+template <class T>
+ArgParser::ArgBuilder<T>& ArgParser::ArgBuilder<T>::MoveValues(std::vector<T>& out) {
+    static_assert(!std::is_same_v<T, bool>, "flags have no values");
+    parser_.options_[index_].sink = static_cast<int32_t>(parser_.sinks_.size());
+    Sink& sink = parser_.sinks_.emplace_back();
+    sink.onValue = [&out](std::string_view text) {
+        if constexpr (std::is_same_v<T, std::string>) {
+            out.emplace_back(text);
+            return ConvertError::Ok;
+        } else {
+            ConvertError err = ParseValue(text, out.emplace_back());
+            if (err != ConvertError::Ok) out.pop_back();
+            return err;
+        }
+    };
+    sink.reset = [&out] { out.clear(); };
+    return *this;
+}
+
+template <class T>
+ArgParser::ArgBuilder<T>& ArgParser::ArgBuilder<T>::MultiValue(size_t minCount) {
+    Option& opt = parser_.options_[index_];
+    opt.multi = true;
+    opt.minCount = static_cast<uint32_t>(minCount);
+    return *this;
+}
+
+template <class T>
+ArgParser::ArgBuilder<T>& ArgParser::ArgBuilder<T>::Positional() {
+    parser_.options_[index_].positional = true;
+    if (parser_.positional_ < 0) parser_.positional_ = static_cast<int>(index_);
+    return *this;
+}
+
+template <class T>
+ConvertError ArgParser::GetValue(const std::string& name, T& out) const {
+    return result_.GetValue(name, out);
+}
+
+template <class T>
+ConvertError ArgParser::GetValues(const std::string& name, std::vector<T>& out) const {
+    return result_.GetValues(name, out);
+}
+
+template <class T>
+ConvertError ParseResult::GetValue(const std::string& name, T& out) const {
+    const Slot* slot = Find(name);
+    if (slot && parser_->options_[slot - slots_.data()].type == ArgType::Custom) {
+        const T* value = ConvertedValue<T>(*slot);
+        if (!value) return ConvertError::Empty;
+        out = *value;
+        return ConvertError::Ok;
+    }
+    std::string_view text;
+    ConvertError err = TextValue(name, text);
+    return err == ConvertError::Ok ? ParseValue(text, out) : err;
+}
+
+template <class T>
+ConvertError ParseResult::GetValues(const std::string& name, std::vector<T>& out) const {
+    const Slot* slot = Find(name);
+    if (slot && parser_->options_[slot - slots_.data()].type == ArgType::Custom) {
+        auto* values = slot->count ? std::any_cast<std::vector<T>>(std::get_if<std::any>(&slot->value)) : nullptr;
+        if (!values) return ConvertError::Empty;
+        out = *values;
+        return ConvertError::Ok;
+    }
+    auto* values = slot ? std::get_if<std::vector<std::string_view>>(&slot->value) : nullptr;
+    if (!values) return ConvertError::Empty;
+    return detail::StoreAllAs<T>(*values, &out);
+}
+
+template <class T>
+const T* ParseResult::ConvertedValue(const Slot& slot) const {
+    const auto& opt = parser_->options_[&slot - slots_.data()];
+    if (opt.multi) {
+        auto* values = slot.count ? std::any_cast<std::vector<T>>(std::get_if<std::any>(&slot.value)) : nullptr;
+        return values && !values->empty() ? &values->front() : nullptr;
+    }
+    return std::any_cast<T>(ArgParser::Payload(slot, opt));
+}
+
+template <class T>
+const ParseResult::Slot* ParseResult::SlotOf(OptionHandle<T> option) const {
+    if (!parser_ || option.parser_ != parser_ || option.index_ >= slots_.size()) return nullptr;
+    return &slots_[option.index_];
+}
+
+template <class T>
+auto ParseResult::Get(OptionHandle<T> option) const {
+    const Slot* slot = SlotOf(option);
+    if constexpr (std::is_same_v<T, int>) {
+        if (!slot) return 0;
+        const auto& opt = parser_->options_[option.Index()];
+        if (auto* values = std::get_if<std::vector<int>>(&slot->value)) return values->empty() ? 0 : values->front();
+        if (!slot->seen) return std::holds_alternative<int>(opt.defaultValue) ? std::get<int>(opt.defaultValue) : 0;
+        return std::get<int>(slot->value);
+    } else if constexpr (std::is_same_v<T, bool>) {
+        if (!slot) return false;
+        const auto& opt = parser_->options_[option.Index()];
+        if (!slot->seen) return std::holds_alternative<bool>(opt.defaultValue) && std::get<bool>(opt.defaultValue);
+        return std::get<bool>(slot->value);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        std::string_view text;
+        if (!slot) return text;
+        const auto& opt = parser_->options_[option.Index()];
+        if (auto* values = std::get_if<std::vector<std::string_view>>(&slot->value)) {
+            if (!values->empty()) text = values->front();
+        }
+        else if (slot->seen) text = std::get<std::string_view>(slot->value);
+        else if (auto* def = std::get_if<std::string>(&opt.defaultValue)) text = *def;
+        return text;
+    } else {
+        const T* value = slot ? ConvertedValue<T>(*slot) : nullptr;
+        return value ? *value : T{};
+    }
+}
+
+template <class T>
+auto ParseResult::Get(OptionHandle<T> option, size_t index) const {
+    static_assert(!std::is_same_v<T, bool>, "flags have no multiple values");
+    const Slot* slot = SlotOf(option);
+    if constexpr (std::is_same_v<T, int>) {
+        auto* values = slot ? std::get_if<std::vector<int>>(&slot->value) : nullptr;
+        return values && index < values->size() ? (*values)[index] : 0;
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        auto* values = slot ? std::get_if<std::vector<std::string_view>>(&slot->value) : nullptr;
+        return values && index < values->size() ? (*values)[index] : std::string_view();
+    } else {
+        auto* values = slot && slot->count ? std::any_cast<std::vector<T>>(std::get_if<std::any>(&slot->value)) : nullptr;
+        return values && index < values->size() ? (*values)[index] : T{};
+    }
+}
+
+template <class T>
+size_t ParseResult::Count(OptionHandle<T> option) const {
+    const Slot* slot = SlotOf(option);
+    if (!slot) return 0;
+    return parser_->options_[option.Index()].multi ? slot->count : (slot->seen ? 1 : 0);
+}
+
+} // namespace ArgumentParser
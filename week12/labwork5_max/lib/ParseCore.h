@@ -0,0 +1,68 @@
+// ParseCore.h
+#pragma once
+
+#include "ValueConverter.h"
+
+#include <string_view>
+
+namespace ArgumentParser {
+
+// Custom — аргумент AddArgument<T>, значение сразу преобразуется ValueConverter<T> и хранится как T
+enum class ArgType { String, Int, Flag, Help, Custom };
+
+namespace detail {
+
+/**
+ * @brief Разбирает один аргумент командной строки
+ *
+ * Общая часть для ArgParser и StaticSchema. Schema ищет опции
+ * (FindLong, FindShort, PositionalIndex, TypeOf), Sink принимает
+ * результат (Value, Flag, Help). Индексы опций — int, -1 означает «нет».
+ * @return false в случае ошибки
+ */
+template <class Schema, class Sink>
+bool ParseArgument(const Schema& schema, Sink& sink, std::string_view arg) {
+    if (arg.substr(0, 2) == "--") {
+        // Обработка длинных опций (--option)
+        if (arg == "--help") {
+            sink.Help();
+            return true;
+        }
+        auto posEq = arg.find('=');
+        std::string_view name = arg.substr(2, posEq == std::string_view::npos ? std::string_view::npos : posEq - 2);
+        int idx = schema.FindLong(name);
+        if (idx < 0) return false;
+        if (schema.TypeOf(idx) == ArgType::Flag) {
+            sink.Flag(idx);
+            return true;
+        }
+        if (posEq == std::string_view::npos) return false;
+        return sink.Value(idx, arg.substr(posEq + 1));
+    }
+    if (arg.substr(0, 1) == "-") {
+        // Обработка коротких опций (-o)
+        if (arg.size() == 2 && arg[1] == 'h') {
+            sink.Help();
+            return true;
+        }
+        if (arg.size() > 2 && arg[2] == '=') {
+            int idx = schema.FindShort(arg[1]);
+            if (idx < 0) return false;
+            return sink.Value(idx, arg.substr(3));
+        }
+        for (size_t k = 1; k < arg.size(); ++k) {
+            int idx = schema.FindShort(arg[k]);
+            if (idx < 0 || schema.TypeOf(idx) != ArgType::Flag) return false;
+            sink.Flag(idx);
+        }
+        return true;
+    }
+    // Обработка позиционного аргумента
+    int idx = schema.PositionalIndex();
+    if (idx < 0) return false;
+    return sink.Value(idx, arg);
+}
+
+} // namespace detail
+
+} // namespace ArgumentParser
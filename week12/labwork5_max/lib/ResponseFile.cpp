@@ -0,0 +1,119 @@
+#include "ResponseFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+namespace ArgumentParser {
+
+    namespace {
+
+        bool IsSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+        }
+
+    } // namespace
+
+    ResponseFile::~ResponseFile() {
+        Close();
+    }
+
+    ResponseFile::ResponseFile(ResponseFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          pos_(std::exchange(other.pos_, 0)),
+          failed_(std::exchange(other.failed_, false)) {
+    }
+
+    ResponseFile& ResponseFile::operator=(ResponseFile&& other) noexcept {
+        if (this != &other) {
+            Close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            pos_ = std::exchange(other.pos_, 0);
+            failed_ = std::exchange(other.failed_, false);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Освобождает отображение файла
+     */
+    void ResponseFile::Close() {
+        if (data_) munmap(data_, size_);
+        data_ = nullptr;
+        size_ = 0;
+        pos_ = 0;
+    }
+
+    /**
+     * @brief Отображает файл ответов в память
+     * @param path Путь к файлу
+     * @return false, если файл не удалось открыть или отобразить
+     */
+    bool ResponseFile::Open(const std::string& path) {
+        Close();
+        failed_ = false;
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return false;
+        }
+        size_t size = static_cast<size_t>(st.st_size);
+        if (size > 0) {
+            void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                close(fd);
+                return false;
+            }
+            madvise(p, size, MADV_SEQUENTIAL);
+            data_ = static_cast<char*>(p);
+            size_ = size;
+        }
+        close(fd);
+        return true;
+    }
+
+    /**
+     * @brief Выделяет следующий аргумент, снимая кавычки и экранирование на месте
+     * @param token Представление аргумента внутри отображения
+     * @return false в конце файла или при незакрытой кавычке (см. Failed)
+     */
+    bool ResponseFile::Next(std::string_view& token) {
+        while (pos_ < size_ && IsSpace(data_[pos_])) ++pos_;
+        if (pos_ >= size_) return false;
+
+        char* out = data_ + pos_;
+        char* w = out;
+        char quote = 0;
+        for (; pos_ < size_; ++pos_) {
+            char c = data_[pos_];
+            if (quote == '\'') {
+                if (c == '\'') { quote = 0; continue; }
+            }
+            else if (c == '\\' && pos_ + 1 < size_ && (!quote || data_[pos_ + 1] == '"' || data_[pos_ + 1] == '\\')) {
+                c = data_[++pos_];
+            }
+            else if (quote == '"') {
+                if (c == '"') { quote = 0; continue; }
+            }
+            else if (c == '"' || c == '\'') { quote = c; continue; }
+            else if (IsSpace(c)) break;
+            // Пока кавычек и экранирования не было, запись не нужна и страница остаётся общей
+            if (w != data_ + pos_) *w = c;
+            ++w;
+        }
+        if (quote) {
+            failed_ = true;
+            return false;
+        }
+        token = std::string_view(out, w - out);
+        return true;
+    }
+
+} // namespace ArgumentParser
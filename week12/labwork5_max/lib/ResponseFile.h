@@ -0,0 +1,44 @@
+// ResponseFile.h
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace ArgumentParser {
+
+/**
+ * @brief Файл ответов (@path), отображённый в память и разбираемый на месте
+ *
+ * Аргументы разделяются пробельными символами. Кавычки '...' берут текст
+ * как есть, в "..." и вне кавычек обратная косая черта экранирует следующий
+ * символ. Отображение частное (MAP_PRIVATE): снятие кавычек переписывает
+ * только затронутые страницы, файл на диске не меняется. Токены — представления
+ * внутри отображения и живут, пока жив объект.
+ */
+class ResponseFile {
+public:
+    ResponseFile() = default;
+    ~ResponseFile();
+
+    ResponseFile(ResponseFile&& other) noexcept;
+    ResponseFile& operator=(ResponseFile&& other) noexcept;
+    ResponseFile(const ResponseFile&) = delete;
+    ResponseFile& operator=(const ResponseFile&) = delete;
+
+    bool Open(const std::string& path);
+
+    // Следующий аргумент; false в конце файла или при незакрытой кавычке
+    bool Next(std::string_view& token);
+    bool Failed() const { return failed_; }
+
+private:
+    void Close();
+
+    char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t pos_ = 0;
+    bool failed_ = false;
+};
+
+} // namespace ArgumentParser
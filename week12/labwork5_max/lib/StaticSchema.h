@@ -0,0 +1,373 @@
+// StaticSchema.h
+#pragma once
+
+#include "ParseCore.h"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser {
+
+// Описание опции, которое можно построить на этапе компиляции
+struct OptionSpec {
+    ArgType type = ArgType::String;
+    char shortName = 0;
+    std::string_view longName;
+    std::string_view description;
+    bool positional = false;
+    bool multi = false;
+    size_t minCount = 0;
+    bool hasDefault = false;
+    std::string_view defaultString;
+    int defaultInt = 0;
+    bool defaultBool = false;
+
+    constexpr OptionSpec Default(std::string_view value) const {
+        OptionSpec s = *this;
+        s.hasDefault = true;
+        s.defaultString = value;
+        return s;
+    }
+    constexpr OptionSpec Default(const char* value) const { return Default(std::string_view(value)); }
+    constexpr OptionSpec Default(int value) const {
+        OptionSpec s = *this;
+        s.hasDefault = true;
+        s.defaultInt = value;
+        return s;
+    }
+    constexpr OptionSpec Default(bool value) const {
+        OptionSpec s = *this;
+        s.hasDefault = true;
+        s.defaultBool = value;
+        return s;
+    }
+    constexpr OptionSpec MultiValue(size_t min = 0) const {
+        OptionSpec s = *this;
+        s.multi = true;
+        s.minCount = min;
+        return s;
+    }
+    constexpr OptionSpec Positional() const {
+        OptionSpec s = *this;
+        s.positional = true;
+        return s;
+    }
+};
+
+constexpr OptionSpec MakeSpec(ArgType type, char shortName, std::string_view name, std::string_view description) {
+    OptionSpec s;
+    s.type = type;
+    s.shortName = shortName;
+    s.longName = name;
+    s.description = description;
+    return s;
+}
+
+constexpr OptionSpec StringArgument(char shortName, std::string_view name, std::string_view description = {}) {
+    return MakeSpec(ArgType::String, shortName, name, description);
+}
+constexpr OptionSpec StringArgument(std::string_view name, std::string_view description = {}) {
+    return MakeSpec(ArgType::String, 0, name, description);
+}
+constexpr OptionSpec IntArgument(char shortName, std::string_view name, std::string_view description = {}) {
+    return MakeSpec(ArgType::Int, shortName, name, description);
+}
+constexpr OptionSpec IntArgument(std::string_view name, std::string_view description = {}) {
+    return MakeSpec(ArgType::Int, 0, name, description);
+}
+constexpr OptionSpec Flag(char shortName, std::string_view name, std::string_view description = {}) {
+    return MakeSpec(ArgType::Flag, shortName, name, description);
+}
+constexpr OptionSpec Flag(std::string_view name, std::string_view description = {}) {
+    return MakeSpec(ArgType::Flag, 0, name, description);
+}
+constexpr OptionSpec HelpOption(char shortName, std::string_view name, std::string_view description = {}) {
+    return MakeSpec(ArgType::Help, shortName, name, description);
+}
+
+namespace detail {
+
+// FNV-1a с перемешиванием; seed выбирает функцию из семейства
+constexpr uint32_t Hash(std::string_view s, uint32_t seed) {
+    uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (char c : s) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 16777619u;
+    }
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return h;
+}
+
+constexpr size_t CeilPow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+} // namespace detail
+
+template <size_t N>
+class StaticResult;
+
+/**
+ * @brief Неизменяемая схема аргументов, построенная на этапе компиляции
+ *
+ * Длинные имена ищутся по совершенной (не минимальной) хеш-функции
+ * (hash-and-displace: корзина по Hash(name, 0), смещение корзины выбирает
+ * функцию Hash(name, d) без коллизий) в таблице из kSlots = CeilPow2(N + N/4 + 1)
+ * ячеек: степень двойки заменяет деление маской, запас упрощает подбор смещений.
+ * Короткие имена ищутся по таблице на 256 символов.
+ * Разбор в StaticResult не выделяет память до первого значения MultiValue.
+ */
+template <size_t N>
+class StaticSchema {
+public:
+    static constexpr size_t kSlots = detail::CeilPow2(N + N / 4 + 1);
+    static constexpr size_t kBuckets = N / 2 + 1;
+
+    constexpr explicit StaticSchema(const std::array<OptionSpec, N>& specs) : specs_(specs) {
+        for (auto& v : shortTable_) v = -1;
+        for (auto& v : slots_) v = -1;
+        for (size_t i = 0; i < N; ++i) {
+            const OptionSpec& s = specs_[i];
+            if (s.positional && positional_ < 0) positional_ = static_cast<int>(i);
+            if (s.shortName) {
+                if (shortTable_[static_cast<uint8_t>(s.shortName)] >= 0) throw "duplicate short option name";
+                shortTable_[static_cast<uint8_t>(s.shortName)] = static_cast<int16_t>(i);
+            }
+            for (size_t j = 0; j < i; ++j) {
+                if (!s.longName.empty() && specs_[j].longName == s.longName) throw "duplicate long option name";
+            }
+        }
+        BuildHash();
+    }
+
+    static constexpr size_t size() { return N; }
+    constexpr const OptionSpec& operator[](size_t i) const { return specs_[i]; }
+
+    constexpr int FindLong(std::string_view name) const {
+        uint32_t b = detail::Hash(name, 0) % kBuckets;
+        int idx = slots_[detail::Hash(name, displacement_[b]) & (kSlots - 1)];
+        return idx >= 0 && specs_[idx].longName == name ? idx : -1;
+    }
+    constexpr int FindShort(char c) const { return c ? shortTable_[static_cast<uint8_t>(c)] : -1; }
+    constexpr int PositionalIndex() const { return positional_; }
+    constexpr ArgType TypeOf(size_t i) const { return specs_[i].type; }
+
+    bool Parse(int argc, char** argv, StaticResult<N>& out) const;
+    bool Parse(const std::string_view* args, size_t count, StaticResult<N>& out) const;
+
+private:
+    constexpr void BuildHash() {
+        std::array<uint32_t, N> bucketOf{};
+        std::array<size_t, kBuckets> bucketSize{};
+        for (size_t i = 0; i < N; ++i) {
+            if (specs_[i].longName.empty()) continue;
+            bucketOf[i] = detail::Hash(specs_[i].longName, 0) % kBuckets;
+            ++bucketSize[bucketOf[i]];
+        }
+
+        std::array<bool, kSlots> taken{};
+        std::array<size_t, N> pos{};
+        // Крупные корзины размещаются первыми
+        for (size_t size = N; size > 0; --size) {
+            for (size_t b = 0; b < kBuckets; ++b) {
+                if (bucketSize[b] != size) continue;
+                for (uint32_t d = 1;; ++d) {
+                    if (d > (1u << 20)) throw "perfect hash construction failed";
+                    size_t placed = 0;
+                    bool ok = true;
+                    for (size_t i = 0; i < N && ok; ++i) {
+                        if (specs_[i].longName.empty() || bucketOf[i] != b) continue;
+                        size_t p = detail::Hash(specs_[i].longName, d) & (kSlots - 1);
+                        if (taken[p]) ok = false;
+                        for (size_t k = 0; k < placed && ok; ++k) {
+                            if (pos[k] == p) ok = false;
+                        }
+                        pos[placed++] = p;
+                    }
+                    if (!ok) continue;
+                    placed = 0;
+                    for (size_t i = 0; i < N; ++i) {
+                        if (specs_[i].longName.empty() || bucketOf[i] != b) continue;
+                        taken[pos[placed]] = true;
+                        slots_[pos[placed++]] = static_cast<int16_t>(i);
+                    }
+                    displacement_[b] = d;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::array<OptionSpec, N> specs_{};
+    std::array<int16_t, 256> shortTable_{};
+    std::array<int16_t, kSlots> slots_{};
+    std::array<uint32_t, kBuckets> displacement_{};
+    int positional_ = -1;
+};
+
+/**
+ * @brief Создаёт схему из списка опций
+ * @code
+ * constexpr auto kSchema = ArgumentParser::MakeSchema(
+ *     ArgumentParser::IntArgument("N").MultiValue(1).Positional(),
+ *     ArgumentParser::Flag("sum", "add args"));
+ * @endcode
+ */
+template <class... Specs>
+constexpr StaticSchema<sizeof...(Specs)> MakeSchema(const Specs&... specs) {
+    return StaticSchema<sizeof...(Specs)>(std::array<OptionSpec, sizeof...(Specs)>{specs...});
+}
+
+/**
+ * @brief Результат разбора по StaticSchema
+ *
+ * Хранит представления на исходные аргументы, поэтому argv
+ * (или массив, переданный в Parse) должен жить дольше результата.
+ */
+template <size_t N>
+class StaticResult {
+public:
+    bool Help() const { return help_; }
+
+    std::string_view GetStringValue(std::string_view name) const {
+        int idx = Find(name);
+        if (idx < 0) return {};
+        const OptionSpec& spec = (*schema_)[idx];
+        const Slot& slot = slots_[idx];
+        if (spec.multi) return slot.values.empty() ? std::string_view() : slot.values[0];
+        return slot.seen ? slot.value : spec.defaultString;
+    }
+
+    int GetIntValue(std::string_view name) const {
+        int idx = Find(name);
+        if (idx < 0) return 0;
+        const OptionSpec& spec = (*schema_)[idx];
+        const Slot& slot = slots_[idx];
+        if (spec.multi) return slot.valuesInt.empty() ? 0 : slot.valuesInt[0];
+        return slot.seen ? slot.valueInt : spec.defaultInt;
+    }
+
+    int GetIntValue(std::string_view name, size_t index) const {
+        int idx = Find(name);
+        if (idx < 0) return 0;
+        const Slot& slot = slots_[idx];
+        return index < slot.valuesInt.size() ? slot.valuesInt[index] : 0;
+    }
+
+    const std::vector<std::string_view>& GetStringValues(std::string_view name) const {
+        static const std::vector<std::string_view> empty;
+        int idx = Find(name);
+        return idx < 0 ? empty : slots_[idx].values;
+    }
+
+    bool GetFlag(std::string_view name) const {
+        int idx = Find(name);
+        if (idx < 0) return false;
+        return slots_[idx].seen ? slots_[idx].flag : (*schema_)[idx].defaultBool;
+    }
+
+private:
+    friend class StaticSchema<N>;
+
+    struct Slot {
+        bool seen = false;
+        bool flag = false;
+        int valueInt = 0;
+        std::string_view value;
+        std::vector<std::string_view> values;
+        std::vector<int> valuesInt;
+    };
+
+    // Приёмник для detail::ParseArgument
+    struct Sink {
+        StaticResult& r;
+
+        bool Value(int idx, std::string_view val) {
+            const OptionSpec& spec = (*r.schema_)[idx];
+            Slot& slot = r.slots_[idx];
+            if (spec.type == ArgType::String) {
+                if (spec.multi) slot.values.push_back(val); else slot.value = val;
+            }
+            else if (spec.type == ArgType::Int) {
+                int v = 0;
+                if (ParseValue(val, v) != ConvertError::Ok) return false;
+                if (spec.multi) slot.valuesInt.push_back(v); else slot.valueInt = v;
+            }
+            else return false;
+            slot.seen = true;
+            return true;
+        }
+        void Flag(int idx) {
+            r.slots_[idx].flag = true;
+            r.slots_[idx].seen = true;
+        }
+        void Help() { r.help_ = true; }
+    };
+
+    int Find(std::string_view name) const { return schema_ ? schema_->FindLong(name) : -1; }
+
+    void Reset(const StaticSchema<N>* schema) {
+        schema_ = schema;
+        help_ = false;
+        for (Slot& slot : slots_) {
+            slot.seen = false;
+            slot.flag = false;
+            slot.values.clear();
+            slot.valuesInt.clear();
+        }
+    }
+
+    bool Validate() const {
+        if (help_) return true;
+        for (size_t i = 0; i < N; ++i) {
+            const OptionSpec& spec = (*schema_)[i];
+            const Slot& slot = slots_[i];
+            if (spec.type == ArgType::String || spec.type == ArgType::Int) {
+                size_t count = spec.type == ArgType::String ? slot.values.size() : slot.valuesInt.size();
+                if (!spec.multi && !slot.seen && !spec.hasDefault) return false;
+                if (spec.multi && count < spec.minCount) return false;
+            }
+        }
+        return true;
+    }
+
+    const StaticSchema<N>* schema_ = nullptr;
+    std::array<Slot, N> slots_{};
+    bool help_ = false;
+};
+
+/**
+ * @brief Разбирает массив аргументов (первый — имя программы)
+ * @return true, если парсинг успешен
+ */
+template <size_t N>
+bool StaticSchema<N>::Parse(const std::string_view* args, size_t count, StaticResult<N>& out) const {
+    out.Reset(this);
+    typename StaticResult<N>::Sink sink{out};
+    for (size_t i = 1; i < count; ++i) {
+        if (!detail::ParseArgument(*this, sink, args[i])) return false;
+    }
+    return out.Validate();
+}
+
+/**
+ * @brief Разбирает argc/argv без копирования аргументов
+ * @return true, если парсинг успешен
+ */
+template <size_t N>
+bool StaticSchema<N>::Parse(int argc, char** argv, StaticResult<N>& out) const {
+    out.Reset(this);
+    typename StaticResult<N>::Sink sink{out};
+    for (int i = 1; i < argc; ++i) {
+        if (!detail::ParseArgument(*this, sink, std::string_view(argv[i]))) return false;
+    }
+    return out.Validate();
+}
+
+} // namespace ArgumentParser
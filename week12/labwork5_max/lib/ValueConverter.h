@@ -0,0 +1,161 @@
+// ValueConverter.h
+#pragma once
+
+#include <any>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace ArgumentParser {
+
+// Результат преобразования значения аргумента
+enum class ConvertError { Ok, Empty, Invalid, OutOfRange };
+
+// Размер с суффиксом: 512, 64K, 2G (множители 1024)
+struct Size {
+    uint64_t bytes = 0;
+};
+
+/**
+ * @brief Преобразование текста аргумента в значение типа T
+ *
+ * Для пользовательского типа достаточно специализации со статическим методом
+ * ConvertError Convert(std::string_view text, T& out). Исключения не используются.
+ */
+template <class T, class Enable = void>
+struct ValueConverter;
+
+namespace detail {
+
+// std::from_chars не принимает ведущий '+', в отличие от std::stoi
+inline std::string_view SkipPlus(std::string_view s) {
+    if (s.size() > 1 && s[0] == '+' && s[1] != '-' && s[1] != '+') s.remove_prefix(1);
+    return s;
+}
+
+template <class T>
+ConvertError FromChars(std::string_view s, T& out) {
+    if (s.empty()) return ConvertError::Empty;
+    s = SkipPlus(s);
+    T value{};
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+    if (ec == std::errc::result_out_of_range) return ConvertError::OutOfRange;
+    if (ec != std::errc() || ptr != s.data() + s.size()) return ConvertError::Invalid;
+    out = value;
+    return ConvertError::Ok;
+}
+
+} // namespace detail
+
+template <class T>
+struct ValueConverter<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+    static ConvertError Convert(std::string_view s, T& out) { return detail::FromChars(s, out); }
+};
+
+template <class T>
+struct ValueConverter<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    static ConvertError Convert(std::string_view s, T& out) { return detail::FromChars(s, out); }
+};
+
+template <>
+struct ValueConverter<bool> {
+    static ConvertError Convert(std::string_view s, bool& out) {
+        if (s.empty()) return ConvertError::Empty;
+        if (s == "true" || s == "1" || s == "yes" || s == "on") { out = true; return ConvertError::Ok; }
+        if (s == "false" || s == "0" || s == "no" || s == "off") { out = false; return ConvertError::Ok; }
+        return ConvertError::Invalid;
+    }
+};
+
+template <>
+struct ValueConverter<std::string> {
+    static ConvertError Convert(std::string_view s, std::string& out) {
+        out.assign(s);
+        return ConvertError::Ok;
+    }
+};
+
+template <>
+struct ValueConverter<std::string_view> {
+    static ConvertError Convert(std::string_view s, std::string_view& out) {
+        out = s;
+        return ConvertError::Ok;
+    }
+};
+
+template <>
+struct ValueConverter<Size> {
+    static ConvertError Convert(std::string_view s, Size& out) {
+        if (s.empty()) return ConvertError::Empty;
+        if (s.back() == 'B' || s.back() == 'b') s.remove_suffix(1);
+        unsigned shift = 0;
+        if (!s.empty()) {
+            switch (s.back()) {
+                case 'K': case 'k': shift = 10; break;
+                case 'M': case 'm': shift = 20; break;
+                case 'G': case 'g': shift = 30; break;
+                case 'T': case 't': shift = 40; break;
+                default: break;
+            }
+        }
+        if (shift) s.remove_suffix(1);
+        uint64_t value = 0;
+        ConvertError err = detail::FromChars(s, value);
+        if (err != ConvertError::Ok) return err;
+        if (value > (std::numeric_limits<uint64_t>::max() >> shift)) return ConvertError::OutOfRange;
+        out.bytes = value << shift;
+        return ConvertError::Ok;
+    }
+};
+
+/**
+ * @brief Преобразует текст в значение типа T через ValueConverter<T>
+ */
+template <class T>
+ConvertError ParseValue(std::string_view s, T& out) {
+    return ValueConverter<T>::Convert(s, out);
+}
+
+namespace detail {
+
+// Стираемые по типу операции для аргументов AddArgument<T>
+// Преобразует значение один раз при разборе и кладёт T в out; для multi-value дописывает
+// в std::vector<T>, first — первое значение опции в этом разборе (память вектора остаётся)
+template <class T>
+ConvertError ConvertInto(std::string_view s, std::any& out, bool multi, bool first) {
+    T value{};
+    ConvertError err = ValueConverter<T>::Convert(s, value);
+    if (err != ConvertError::Ok) return err;
+    if (multi) {
+        auto* values = std::any_cast<std::vector<T>>(&out);
+        if (!values) values = &out.emplace<std::vector<T>>();
+        if (first) values->clear();
+        values->push_back(std::move(value));
+    }
+    else if (auto* single = std::any_cast<T>(&out)) *single = std::move(value);
+    else out.emplace<T>(std::move(value));
+    return ConvertError::Ok;
+}
+
+template <class T>
+ConvertError StoreAllAs(const std::vector<std::string_view>& values, void* out) {
+    auto& target = *static_cast<std::vector<T>*>(out);
+    target.clear();
+    target.reserve(values.size());
+    for (std::string_view s : values) {
+        T value{};
+        ConvertError err = ValueConverter<T>::Convert(s, value);
+        if (err != ConvertError::Ok) return err;
+        target.push_back(std::move(value));
+    }
+    return ConvertError::Ok;
+}
+
+} // namespace detail
+
+} // namespace ArgumentParser
@@ -1,6 +1,10 @@
 #include <./lib/ArgParser.h>
+#include <./lib/StaticSchema.h>
 #include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
+#include <thread>
 
 
 using namespace ArgumentParser;
@@ -173,3 +177,375 @@ TEST(ArgParserTestSuite, HelpStringTest) {
     //     "-h, --help Display this help and exit\n"
     // );
 }
+
+
+TEST(ArgParserTestSuite, ArgvTest) {
+    ArgParser parser("My Parser");
+    std::vector<std::string> files;
+    parser.AddStringArgument('o', "output");
+    parser.AddStringArgument("Files").MultiValue(1).Positional().StoreValues(files);
+
+    char arg0[] = "app", arg1[] = "-o=result.txt", arg2[] = "a.txt", arg3[] = "b.txt";
+    char* argv[] = {arg0, arg1, arg2, arg3};
+    ASSERT_TRUE(parser.Parse(4, argv));
+    ASSERT_EQ(parser.GetStringValue("output"), "result.txt");
+    ASSERT_EQ(files, std::vector<std::string>({"a.txt", "b.txt"}));
+}
+
+
+TEST(ArgParserTestSuite, TemporaryArgsTest) {
+    ArgParser parser("My Parser");
+    parser.AddStringArgument("param1").MultiValue();
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --param1=first --param1=second")));
+    ASSERT_EQ(parser.GetStringValue("param1"), "first");
+}
+
+
+constexpr auto kStaticSchema = MakeSchema(
+    IntArgument("N").MultiValue(1).Positional(),
+    Flag('s', "sum", "add args"),
+    Flag('m', "mult", "multiply args"),
+    StringArgument('o', "output").Default("out.txt"),
+    IntArgument("level").Default(3)
+);
+
+static_assert(kStaticSchema.FindLong("sum") == 1);
+static_assert(kStaticSchema.FindLong("output") == 3);
+static_assert(kStaticSchema.FindLong("unknown") == -1);
+static_assert(kStaticSchema.FindShort('m') == 2);
+
+
+TEST(ArgParserTestSuite, StaticSchemaTest) {
+    char arg0[] = "app", arg1[] = "--sum", arg2[] = "1", arg3[] = "2", arg4[] = "--level=7";
+    char* argv[] = {arg0, arg1, arg2, arg3, arg4};
+    StaticResult<kStaticSchema.size()> result;
+
+    ASSERT_TRUE(kStaticSchema.Parse(5, argv, result));
+    ASSERT_TRUE(result.GetFlag("sum"));
+    ASSERT_FALSE(result.GetFlag("mult"));
+    ASSERT_EQ(result.GetIntValue("N", 1), 2);
+    ASSERT_EQ(result.GetIntValue("level"), 7);
+    ASSERT_EQ(result.GetStringValue("output"), "out.txt");
+}
+
+
+TEST(ArgParserTestSuite, StaticSchemaErrorTest) {
+    StaticResult<kStaticSchema.size()> result;
+    std::vector<std::string_view> noValues = {"app", "--sum"};
+    std::vector<std::string_view> unknown = {"app", "1", "--sumx"};
+    std::vector<std::string_view> shortCluster = {"app", "-sm", "5"};
+
+    ASSERT_FALSE(kStaticSchema.Parse(noValues.data(), noValues.size(), result));
+    ASSERT_FALSE(kStaticSchema.Parse(unknown.data(), unknown.size(), result));
+    ASSERT_TRUE(kStaticSchema.Parse(shortCluster.data(), shortCluster.size(), result));
+    ASSERT_TRUE(result.GetFlag("mult"));
+}
+
+
+TEST(ArgParserTestSuite, TypedArgumentTest) {
+    ArgParser parser("My Parser");
+    int64_t offset = 0;
+    std::vector<uint64_t> ids;
+    Size cache;
+    parser.AddArgument<int64_t>("offset").StoreValue(offset);
+    parser.AddArgument<uint64_t>("id").MultiValue(1).StoreValues(ids);
+    parser.AddArgument<double>('r', "ratio").Default("0.5");
+    parser.AddArgument<Size>("cache").StoreValue(cache);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --offset=-9000000000 --id=18446744073709551615 --id=+7 --cache=64KB")));
+    ASSERT_EQ(offset, -9000000000LL);
+    ASSERT_EQ(ids, std::vector<uint64_t>({18446744073709551615ULL, 7}));
+    ASSERT_EQ(cache.bytes, 64u * 1024);
+    double ratio = 0;
+    ASSERT_EQ(parser.GetValue("ratio", ratio), ConvertError::Ok);
+    ASSERT_DOUBLE_EQ(ratio, 0.5);
+}
+
+
+TEST(ArgParserTestSuite, MalformedValueTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument("param1");
+    parser.AddArgument<uint8_t>("small");
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --param1=12abc --small=1")));
+    ASSERT_EQ(parser.LastError(), ConvertError::Invalid);
+    ASSERT_FALSE(parser.Parse(SplitString("app --param1=1 --small=300")));
+    ASSERT_EQ(parser.LastError(), ConvertError::OutOfRange);
+    ASSERT_FALSE(parser.Parse(SplitString("app --param1=99999999999 --small=1")));
+    ASSERT_TRUE(parser.Parse(SplitString("app --param1=+5 --small=1")));
+    ASSERT_EQ(parser.GetIntValue("param1"), 5);
+}
+
+
+struct Point {
+    int x = 0;
+    int y = 0;
+};
+
+template <>
+struct ArgumentParser::ValueConverter<Point> {
+    static ConvertError Convert(std::string_view s, Point& out) {
+        auto comma = s.find(',');
+        if (comma == std::string_view::npos) return ConvertError::Invalid;
+        ConvertError err = ParseValue(s.substr(0, comma), out.x);
+        return err != ConvertError::Ok ? err : ParseValue(s.substr(comma + 1), out.y);
+    }
+};
+
+
+TEST(ArgParserTestSuite, UserTypeTest) {
+    ArgParser parser("My Parser");
+    Point origin;
+    parser.AddArgument<Point>('p', "point").StoreValue(origin);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -p=3,-4")));
+    ASSERT_EQ(origin.x, 3);
+    ASSERT_EQ(origin.y, -4);
+    ASSERT_FALSE(parser.Parse(SplitString("app -p=3")));
+}
+
+
+TEST(ArgParserTestSuite, ResponseFileTest) {
+    std::string path = (std::filesystem::temp_directory_path() / "argparser_response.txt").string();
+    {
+        std::ofstream out(path);
+        out << "--name=\"John Smith\" -o='a b'\n--path=C:\\\\dir\\ x";
+        for (int i = 1; i <= 1000; ++i) out << ' ' << i;
+        out << '\n';
+    }
+    ArgParser parser("My Parser");
+    std::vector<int> values;
+    parser.AddIntArgument("N").MultiValue(1).Positional().StoreValues(values);
+    parser.AddStringArgument("name");
+    parser.AddStringArgument('o', "output");
+    parser.AddStringArgument("path");
+    parser.AddFlag("sum");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app 0 @" + path + " --sum")));
+    ASSERT_EQ(parser.GetStringValue("name"), "John Smith");
+    ASSERT_EQ(parser.GetStringValue("output"), "a b");
+    ASSERT_EQ(parser.GetStringValue("path"), "C:\\dir x");
+    ASSERT_TRUE(parser.GetFlag("sum"));
+    ASSERT_EQ(values.size(), 1001u);
+    ASSERT_EQ(values.back(), 1000);
+
+    { std::ofstream(path) << "--name=\"unterminated"; }
+    ASSERT_FALSE(parser.Parse(SplitString("app 1 @" + path)));
+    ASSERT_FALSE(parser.Parse(SplitString("app 1 @" + path + ".missing")));
+    std::filesystem::remove(path);
+}
+
+
+TEST(ArgParserTestSuite, SharedSchemaTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument("N").MultiValue(1).Positional();
+    parser.AddStringArgument('o', "output").Default("out.txt");
+    parser.AddFlag("sum");
+    const ArgParser& schema = parser;
+
+    std::vector<std::thread> workers;
+    std::vector<int> failures(4, 0);
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&schema, &failures, t] {
+            ParseResult result;
+            for (int i = 0; i < 200; ++i) {
+                std::string args = "app " + std::to_string(t) + " " + std::to_string(i) + " -o=" + std::to_string(t);
+                if (i % 2) args += " --sum";
+                bool ok = schema.Parse(SplitString(args), result);
+                if (!ok || result.GetIntValue("N", 0) != t || result.GetIntValue("N", 1) != i
+                    || result.GetStringValue("output") != std::to_string(t) || result.GetFlag("sum") != (i % 2 == 1)) {
+                    ++failures[t];
+                }
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    ASSERT_EQ(failures, std::vector<int>(4, 0));
+
+    ParseResult result;
+    ASSERT_TRUE(schema.Parse(SplitString("app 1"), result));
+    ASSERT_EQ(result.GetStringValue("output"), "out.txt");
+    ASSERT_FALSE(schema.Parse(SplitString("app --sum"), result));
+}
+
+
+TEST(ArgParserTestSuite, OptionHandleTest) {
+    ArgParser parser("My Parser");
+    OptionHandle<int> numbers = parser.AddIntArgument("N").MultiValue(1).Positional();
+    OptionHandle<std::string> output = parser.AddStringArgument('o', "output").Default("out.txt");
+    OptionHandle<bool> sum = parser.AddFlag('s', "sum");
+    OptionHandle<double> ratio = parser.AddArgument<double>("ratio").Default("0.25");
+    OptionHandle<int> level = parser.AddIntArgument("level").Default(3);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app 4 5 6 -s --level=7")));
+    ASSERT_EQ(parser.Count(numbers), 3u);
+    ASSERT_EQ(parser.Get(numbers, 2), 6);
+    ASSERT_EQ(parser.Get(output), "out.txt");
+    ASSERT_TRUE(parser.Get(sum));
+    ASSERT_DOUBLE_EQ(parser.Get(ratio), 0.25);
+    ASSERT_EQ(parser.Get(level), 7);
+
+    ParseResult result;
+    ASSERT_TRUE(parser.Parse(SplitString("app 1 -o=log.txt --ratio=2.5"), result));
+    ASSERT_EQ(result.Get(output), "log.txt");
+    ASSERT_FALSE(result.Get(sum));
+    ASSERT_DOUBLE_EQ(result.Get(ratio), 2.5);
+    ASSERT_EQ(result.Get(level), 3);
+}
+
+
+struct Counted {
+    int value = 0;
+    static inline int conversions = 0;
+};
+
+template <>
+struct ArgumentParser::ValueConverter<Counted> {
+    static ConvertError Convert(std::string_view s, Counted& out) {
+        ++Counted::conversions;
+        return ParseValue(s, out.value);
+    }
+};
+
+
+TEST(ArgParserTestSuite, OptionHandleSafetyTest) {
+    ArgParser parser("My Parser");
+    ArgParser other("Other Parser");
+    OptionHandle<int> level = parser.AddIntArgument("level").Default(3);
+    Counted storedWeight;
+    std::vector<Counted> storedExtra;
+    OptionHandle<Counted> weight = parser.AddArgument<Counted>("weight").Default("5").StoreValue(storedWeight);
+    OptionHandle<Counted> extra = parser.AddArgument<Counted>("extra").MultiValue().StoreValues(storedExtra);
+    OptionHandle<int> foreign = other.AddIntArgument("level").Default(9);
+    OptionHandle<int> unbound;
+
+    // До разбора, чужой и пустой дескрипторы читаются как отсутствие значения
+    ParseResult result;
+    ASSERT_EQ(result.Get(level), 0);
+    ASSERT_EQ(result.Count(extra), 0u);
+    ASSERT_TRUE(parser.Parse(SplitString("app --weight=2 --extra=4 --extra=6"), result));
+    ASSERT_EQ(result.Get(foreign), 0);
+    ASSERT_EQ(result.Get(unbound), 0);
+    ASSERT_EQ(result.Count(foreign), 0u);
+    ASSERT_EQ(result.Get(level), 3);
+
+    // Значения AddArgument<T> преобразуются один раз при разборе, а не при каждом Get
+    int converted = Counted::conversions;
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(result.Get(weight).value, 2);
+        ASSERT_EQ(result.Get(extra, 1).value, 6);
+    }
+    ASSERT_EQ(result.Get(extra).value, 4);
+    ASSERT_EQ(result.Get(extra, 2).value, 0);
+    ASSERT_EQ(Counted::conversions, converted);
+
+    // StoreValue/StoreValues копируют уже преобразованные значения: по одному преобразованию на аргумент
+    ASSERT_TRUE(parser.Parse(SplitString("app --weight=2 --extra=4 --extra=6")));
+    ASSERT_EQ(Counted::conversions - converted, 3);
+    ASSERT_EQ(storedWeight.value, 2);
+    ASSERT_EQ(storedExtra.size(), 2u);
+    ASSERT_EQ(storedExtra[1].value, 6);
+    converted = Counted::conversions;
+    ASSERT_TRUE(parser.Parse(SplitString("app")));
+    ASSERT_EQ(Counted::conversions, converted);
+    ASSERT_EQ(storedWeight.value, 5);
+    ASSERT_TRUE(storedExtra.empty());
+
+    ASSERT_TRUE(parser.Parse(SplitString("app"), result));
+    ASSERT_EQ(result.Get(weight).value, 5);
+    ASSERT_EQ(result.Count(extra), 0u);
+    ASSERT_EQ(result.Get(extra, 0).value, 0);
+
+    ASSERT_THROW(parser.AddArgument<double>("ratio").Default("fast"), std::invalid_argument);
+    ASSERT_THROW(parser.AddArgument<Counted>("count").Default("1x"), std::invalid_argument);
+}
+
+TEST(ArgParserTestSuite, ValueSinkTest) {
+    ArgParser parser("My Parser");
+    int64_t total = 0;
+    std::vector<std::string> names;
+    std::vector<int> ids;
+    OptionHandle<int64_t> numbers = parser.AddArgument<int64_t>("N").MultiValue(2).Positional()
+        .OnValue([&total](int64_t v) { total += v; });
+    parser.AddStringArgument("name").MultiValue().OnValue([&names](std::string_view v) { names.emplace_back(v); });
+    OptionHandle<int> id = parser.AddIntArgument("id").MultiValue(1).MoveValues(ids);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app 10 20 30 --name=a --id=7 --name=b --id=8")));
+    ASSERT_EQ(total, 60);
+    ASSERT_EQ(parser.Count(numbers), 3u);
+    ASSERT_EQ(names, std::vector<std::string>({"a", "b"}));
+    ASSERT_EQ(ids, std::vector<int>({7, 8}));
+
+    ParseResult result;
+    ASSERT_FALSE(parser.Parse(SplitString("app 1 --id=1"), result));
+    ASSERT_FALSE(parser.Parse(SplitString("app 1 2 --id=x"), result));
+    ASSERT_EQ(result.LastError(), ConvertError::Invalid);
+    ASSERT_TRUE(parser.Parse(SplitString("app 1 2 --id=3 --name=c"), result));
+    // Константный Parse не трогает приёмники: значения остаются в результате
+    ASSERT_EQ(total, 60);
+    ASSERT_EQ(names, std::vector<std::string>({"a", "b"}));
+    ASSERT_EQ(ids, std::vector<int>({7, 8}));
+    ASSERT_EQ(result.Count(id), 1u);
+    ASSERT_EQ(result.Get(id, 0), 3);
+    ASSERT_EQ(result.Get(numbers, 1), 2);
+    ASSERT_EQ(result.GetStringValue("name"), "c");
+
+    std::vector<std::thread> workers;
+    std::vector<int> sums(4, 0);
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&parser, &sums, numbers, id, t] {
+            ParseResult local;
+            for (int i = 0; i < 200; ++i) {
+                if (!parser.Parse(SplitString("app 1 " + std::to_string(t) + " --id=" + std::to_string(i)), local)) return;
+                sums[t] += static_cast<int>(local.Get(numbers, 1)) + local.Get(id);
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    for (int t = 0; t < 4; ++t) ASSERT_EQ(sums[t], 200 * t + 199 * 200 / 2);
+    ASSERT_EQ(ids, std::vector<int>({7, 8}));
+
+    ASSERT_TRUE(parser.Parse(SplitString("app 1 2 --id=3")));
+    ASSERT_EQ(ids, std::vector<int>({3}));
+    ASSERT_EQ(total, 63);
+}
+
+
+TEST(ArgParserTestSuite, SubcommandTest) {
+    ArgParser parser("My Parser");
+    int built = 0;
+    int jobs = 0;
+    parser.AddFlag('v', "verbose");
+    parser.AddSubcommand("build", "Build targets", [&built, &jobs](ArgParser& cmd) {
+        ++built;
+        cmd.AddIntArgument('j', "jobs").Default(1).StoreValue(jobs);
+        cmd.AddStringArgument("target").MultiValue(1).Positional();
+    });
+    parser.AddSubcommand("clean", "Remove outputs", [&built](ArgParser& cmd) {
+        ++built;
+        cmd.AddFlag("all");
+    });
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -v")));
+    ASSERT_EQ(built, 0);
+    ASSERT_EQ(parser.Subcommand(), "");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -v build -j=4 lib app")));
+    ASSERT_EQ(built, 1);
+    ASSERT_EQ(parser.Subcommand(), "build");
+    ASSERT_TRUE(parser.GetFlag("verbose"));
+    ASSERT_EQ(jobs, 4);
+    ASSERT_EQ(parser.SubcommandParser()->GetStringValue("target"), "lib");
+
+    ParseResult result;
+    ASSERT_TRUE(parser.Parse(SplitString("app build core"), result));
+    ASSERT_EQ(built, 1);
+    ASSERT_EQ(result.SubcommandResult()->GetIntValue("jobs"), 1);
+    ASSERT_FALSE(parser.Parse(SplitString("app build -j=2"), result));
+    ASSERT_FALSE(parser.Parse(SplitString("app build --all"), result));
+    ASSERT_TRUE(parser.Parse(SplitString("app clean --all"), result));
+    ASSERT_EQ(built, 2);
+    ASSERT_EQ(result.Subcommand(), "clean");
+    ASSERT_TRUE(result.SubcommandResult()->GetFlag("all"));
+}
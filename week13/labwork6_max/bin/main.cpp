@@ -1,6 +1,4 @@
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include "lib/parser.h"
 #include "lib/beauty.h"
 
@@ -12,17 +10,14 @@ int main(int argc, char* argv[]) {
         path = argv[1];
     }
 
-    std::ifstream file(path);
-    if (!file) {
-        std::cerr << "Cannot open file: " << path << std::endl;
+    // Файл отображается в память и разбирается без промежуточных копий
+    Config cfg;
+    try {
+        cfg = ParseFile(path);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
         return 1;
     }
-
-    std::ostringstream ss;
-    ss << file.rdbuf();
-    std::string content = ss.str();
-
-    Config cfg = Parse(content);
     if (!cfg.IsValid()) {
         std::cerr << "Parse error." << std::endl;
         return 2;
@@ -32,7 +27,7 @@ int main(int argc, char* argv[]) {
         std::cout << "Loaded successfully\n";
 
         // Вывод корневой секции
-        beauty::PrintSection(cfg.root_, "root");
+        beauty::PrintSection(*cfg.root_, "root");
 
         // Получаем секцию [level1]
         if (!cfg.Has("level1")) {
@@ -0,0 +1,28 @@
+#include <iostream>
+#include "lib/compiled.h"
+
+using namespace omfl;
+
+// Компилятор OMFL: разбирает текстовый файл и записывает бинарный образ,
+// который затем открывается через CompiledConfig::Open без разбора
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input.omfl> <output.omflc>" << std::endl;
+        return 1;
+    }
+
+    try {
+        Config cfg = ParseFile(argv[1]);
+        if (!cfg.IsValid()) {
+            std::cerr << "Parse error." << std::endl;
+            return 2;
+        }
+        WriteImage(cfg, argv[2]);
+        CompiledConfig::Open(argv[2]);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 3;
+    }
+
+    return 0;
+}
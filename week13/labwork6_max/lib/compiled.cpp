@@ -0,0 +1,420 @@
+#include "compiled.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace omfl {
+
+static constexpr char kMagic[8] = {'O', 'M', 'F', 'L', 'I', 'M', 'G', '\0'};
+static constexpr std::uint32_t kVersion = 1;
+static constexpr std::uint32_t kByteOrderMark = 0x01020304;
+static constexpr std::uint32_t kHeaderSize = 32;
+static constexpr std::uint32_t kSlotSize = 12;  // {тег, a, b}
+static constexpr std::uint32_t kEntrySize = 20; // {смещение ключа, длина ключа, тег, a, b}
+
+enum class Tag : std::uint32_t { Int, Float, Bool, String, Array, Section };
+
+/**
+ * @brief Читает uint32 по невыровненному адресу
+ */
+static std::uint32_t Load32(const char* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Записывает uint32 в уже выделенное место буфера
+ */
+static void Store32(std::string& out, size_t pos, std::uint32_t v) {
+    std::memcpy(&out[pos], &v, sizeof(v));
+}
+
+/**
+ * @brief Проверяет, что диапазон [offset, offset + len) лежит внутри образа
+ * @throws std::runtime_error если образ повреждён
+ */
+static void CheckRange(std::uint64_t offset, std::uint64_t len, std::uint64_t size) {
+    if (offset > size || len > size - offset) throw std::runtime_error("Corrupted OMFL image");
+}
+
+/**
+ * @brief Построитель образа: записи секций и массивов, затем таблица строк
+ */
+struct ImageWriter {
+    std::string out;
+    std::string strings;
+    std::unordered_map<std::string_view, std::uint32_t> interned;
+
+    /**
+     * @brief Добавляет строку в таблицу строк без повторов
+     * @return Смещение строки в таблице
+     */
+    std::uint32_t Intern(std::string_view s) {
+        auto [it, inserted] = interned.try_emplace(s, static_cast<std::uint32_t>(strings.size()));
+        if (inserted) {
+            if (strings.size() + s.size() > UINT32_MAX) throw std::runtime_error("OMFL image too large");
+            strings.append(s);
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief Заполняет тройку {тег, a, b} по заранее выделенному смещению
+     *
+     * Вложенные массивы и секции дописываются в конец, поэтому запись идёт
+     * по позиции: буфер при этом может переместиться.
+     */
+    void WriteSlot(size_t pos, const Value& v) {
+        Tag tag;
+        std::uint32_t a = 0;
+        std::uint32_t b = 0;
+        if (v.IsInt()) {
+            tag = Tag::Int;
+            a = static_cast<std::uint32_t>(v.AsInt());
+        } else if (v.IsFloat()) {
+            tag = Tag::Float;
+            float f = v.AsFloat();
+            std::memcpy(&a, &f, sizeof(a));
+        } else if (v.IsBool()) {
+            tag = Tag::Bool;
+            a = v.AsBool();
+        } else if (v.IsString()) {
+            tag = Tag::String;
+            a = Intern(v.AsString());
+            b = static_cast<std::uint32_t>(v.AsString().size());
+        } else if (v.IsArray()) {
+            tag = Tag::Array;
+            a = WriteArray(v.AsArray());
+        } else if (v.IsSection()) {
+            tag = Tag::Section;
+            a = WriteSection(v.AsSection());
+        } else {
+            throw std::runtime_error("Bad value");
+        }
+        Store32(out, pos, static_cast<std::uint32_t>(tag));
+        Store32(out, pos + 4, a);
+        Store32(out, pos + 8, b);
+    }
+
+    /**
+     * @brief Записывает массив
+     * @return Смещение записи массива
+     */
+    std::uint32_t WriteArray(const std::pmr::vector<Value>& arr) {
+        size_t off = Reserve(4 + arr.size() * kSlotSize);
+        Store32(out, off, static_cast<std::uint32_t>(arr.size()));
+        for (size_t i = 0; i < arr.size(); ++i) WriteSlot(off + 4 + i * kSlotSize, arr[i]);
+        return static_cast<std::uint32_t>(off);
+    }
+
+    /**
+     * @brief Записывает секцию; ключи уже отсортированы Parse
+     * @return Смещение записи секции
+     */
+    std::uint32_t WriteSection(const Section& sec) {
+        size_t off = Reserve(4 + sec.values_.size() * kEntrySize);
+        Store32(out, off, static_cast<std::uint32_t>(sec.values_.size()));
+        for (size_t i = 0; i < sec.values_.size(); ++i) {
+            const auto& [key, value] = sec.values_[i];
+            size_t pos = off + 4 + i * kEntrySize;
+            Store32(out, pos, Intern(key));
+            Store32(out, pos + 4, static_cast<std::uint32_t>(key.size()));
+            WriteSlot(pos + 8, value);
+        }
+        return static_cast<std::uint32_t>(off);
+    }
+
+    /**
+     * @brief Выделяет место в конце образа
+     * @return Смещение выделенного места
+     */
+    size_t Reserve(size_t bytes) {
+        size_t off = out.size();
+        if (off + bytes > UINT32_MAX) throw std::runtime_error("OMFL image too large");
+        out.resize(off + bytes);
+        return off;
+    }
+};
+
+/**
+ * @brief Сериализует конфигурацию в бинарный образ
+ * @param cfg Валидная конфигурация (ленивые значения будут разобраны)
+ * @return Образ, готовый к записи в файл
+ * @throws std::runtime_error для невалидной конфигурации или слишком большого образа
+ */
+std::string CompileImage(const Config& cfg) {
+    if (!cfg.IsValid()) throw std::runtime_error("Invalid config");
+    ImageWriter w;
+    w.Reserve(kHeaderSize);
+    std::uint32_t root = w.WriteSection(*cfg.root_);
+    size_t strings = w.out.size();
+    if (strings + w.strings.size() > UINT32_MAX) throw std::runtime_error("OMFL image too large");
+    w.out += w.strings;
+    std::memcpy(&w.out[0], kMagic, sizeof(kMagic));
+    Store32(w.out, 8, kVersion);
+    Store32(w.out, 12, kByteOrderMark);
+    Store32(w.out, 16, static_cast<std::uint32_t>(w.out.size()));
+    Store32(w.out, 20, root);
+    Store32(w.out, 24, static_cast<std::uint32_t>(strings));
+    Store32(w.out, 28, static_cast<std::uint32_t>(w.strings.size()));
+    return std::move(w.out);
+}
+
+/**
+ * @brief Записывает образ конфигурации в файл
+ * @throws std::runtime_error если конфигурация невалидна или файл не записан
+ */
+void WriteImage(const Config& cfg, const std::string& path) {
+    std::string image = CompileImage(cfg);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.write(image.data(), static_cast<std::streamsize>(image.size()))) {
+        throw std::runtime_error("Cannot write file: " + path);
+    }
+}
+
+#define SLOT_CHECK(tag) if (Load32(img_.base + slot_) != static_cast<std::uint32_t>(Tag::tag)) throw std::runtime_error("Bad type");
+
+bool CompiledValue::IsInt()     const { return Load32(img_.base + slot_) == static_cast<std::uint32_t>(Tag::Int); }
+bool CompiledValue::IsFloat()   const { return Load32(img_.base + slot_) == static_cast<std::uint32_t>(Tag::Float); }
+bool CompiledValue::IsBool()    const { return Load32(img_.base + slot_) == static_cast<std::uint32_t>(Tag::Bool); }
+bool CompiledValue::IsString()  const { return Load32(img_.base + slot_) == static_cast<std::uint32_t>(Tag::String); }
+bool CompiledValue::IsArray()   const { return Load32(img_.base + slot_) == static_cast<std::uint32_t>(Tag::Array); }
+bool CompiledValue::IsSection() const { return Load32(img_.base + slot_) == static_cast<std::uint32_t>(Tag::Section); }
+
+/**
+ * @brief Возвращает значение как целое число
+ * @throws std::runtime_error если тип не INT
+ */
+int CompiledValue::AsInt() const { SLOT_CHECK(Int); return static_cast<int>(Load32(img_.base + slot_ + 4)); }
+
+/**
+ * @brief Возвращает значение как число с плавающей точкой
+ * @throws std::runtime_error если тип не FLOAT
+ */
+float CompiledValue::AsFloat() const {
+    SLOT_CHECK(Float);
+    float f;
+    std::memcpy(&f, img_.base + slot_ + 4, sizeof(f));
+    return f;
+}
+
+/**
+ * @brief Возвращает значение как булево
+ * @throws std::runtime_error если тип не BOOL
+ */
+bool CompiledValue::AsBool() const { SLOT_CHECK(Bool); return Load32(img_.base + slot_ + 4) != 0; }
+
+/**
+ * @brief Возвращает строку — представление внутри таблицы строк образа
+ * @throws std::runtime_error если тип не STRING или образ повреждён
+ */
+std::string_view CompiledValue::AsString() const {
+    SLOT_CHECK(String);
+    std::uint32_t off = Load32(img_.base + slot_ + 4);
+    std::uint32_t len = Load32(img_.base + slot_ + 8);
+    CheckRange(off, len, img_.stringsSize);
+    return std::string_view(img_.base + img_.strings + off, len);
+}
+
+/**
+ * @brief Возвращает значение как массив
+ * @throws std::runtime_error если тип не ARRAY или образ повреждён
+ */
+CompiledArray CompiledValue::AsArray() const { SLOT_CHECK(Array); return CompiledArray(img_, Load32(img_.base + slot_ + 4)); }
+
+/**
+ * @brief Возвращает значение как секцию
+ * @throws std::runtime_error если тип не SECTION или образ повреждён
+ */
+CompiledSection CompiledValue::AsSection() const { SLOT_CHECK(Section); return CompiledSection(img_, Load32(img_.base + slot_ + 4)); }
+
+/**
+ * @brief Открывает запись массива, проверяя её границы
+ * @throws std::runtime_error если образ повреждён
+ */
+CompiledArray::CompiledArray(const ImageRef& img, std::uint32_t offset) : img_(img), offset_(offset) {
+    CheckRange(offset, 4, img.strings);
+    count_ = Load32(img.base + offset);
+    CheckRange(offset + 4, static_cast<std::uint64_t>(count_) * kSlotSize, img.strings);
+}
+
+/**
+ * @brief Возвращает элемент массива; индекс проверяется, чтобы не читать за записью
+ * @throws std::out_of_range если индекс вне массива
+ */
+CompiledValue CompiledArray::operator[](size_t i) const {
+    if (i >= count_) throw std::out_of_range("CompiledArray::operator[]");
+    return CompiledValue(img_, static_cast<std::uint32_t>(offset_ + 4 + i * kSlotSize));
+}
+
+/**
+ * @brief Возвращает элемент массива с проверкой индекса
+ * @throws std::out_of_range если индекс вне массива
+ */
+CompiledValue CompiledArray::at(size_t i) const {
+    if (i >= count_) throw std::out_of_range("CompiledArray::at");
+    return (*this)[i];
+}
+
+/**
+ * @brief Открывает запись секции, проверяя её границы
+ * @throws std::runtime_error если образ повреждён
+ */
+CompiledSection::CompiledSection(const ImageRef& img, std::uint32_t offset) : img_(img), offset_(offset) {
+    CheckRange(offset, 4, img.strings);
+    count_ = Load32(img.base + offset);
+    CheckRange(offset + 4, static_cast<std::uint64_t>(count_) * kEntrySize, img.strings);
+}
+
+/**
+ * @brief Возвращает i-й ключ секции
+ * @throws std::runtime_error если образ повреждён
+ */
+/**
+ * @brief Возвращает ключ записи в порядке сортировки
+ * @throws std::out_of_range если индекс вне секции
+ * @throws std::runtime_error если образ повреждён
+ */
+std::string_view CompiledSection::KeyAt(size_t i) const {
+    if (i >= count_) throw std::out_of_range("CompiledSection::KeyAt");
+    const char* entry = img_.base + offset_ + 4 + i * kEntrySize;
+    std::uint32_t off = Load32(entry);
+    std::uint32_t len = Load32(entry + 4);
+    CheckRange(off, len, img_.stringsSize);
+    return std::string_view(img_.base + img_.strings + off, len);
+}
+
+/**
+ * @brief Возвращает значение записи в порядке сортировки
+ * @throws std::out_of_range если индекс вне секции
+ */
+CompiledValue CompiledSection::ValueAt(size_t i) const {
+    if (i >= count_) throw std::out_of_range("CompiledSection::ValueAt");
+    return CompiledValue(img_, static_cast<std::uint32_t>(offset_ + 4 + i * kEntrySize + 8));
+}
+
+/**
+ * @brief Ищет ключ бинарным поиском
+ * @return Индекс записи или Size(), если ключа нет
+ */
+size_t CompiledSection::Find(std::string_view key) const {
+    size_t lo = 0;
+    size_t hi = count_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (KeyAt(mid) < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < count_ && KeyAt(lo) == key ? lo : count_;
+}
+
+/**
+ * @brief Получает значение по ключу
+ * @throws std::runtime_error если ключ не найден
+ */
+CompiledValue CompiledSection::Get(std::string_view key) const {
+    size_t i = Find(key);
+    if (i == count_) throw std::runtime_error("Key not found");
+    return ValueAt(i);
+}
+
+bool CompiledSection::Has(std::string_view key) const { return Find(key) != count_; }
+
+/**
+ * @brief Открывает образ в памяти, проверяя заголовок
+ * @param image Байты образа; должны жить дольше результата
+ * @throws std::runtime_error если это не образ OMFL этой версии или он записан с другим порядком байт
+ */
+CompiledConfig CompiledConfig::FromMemory(std::string_view image) {
+    if (image.size() < kHeaderSize || image.size() > UINT32_MAX ||
+        std::memcmp(image.data(), kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not an OMFL image");
+    }
+    const char* p = image.data();
+    if (Load32(p + 12) != kByteOrderMark) throw std::runtime_error("OMFL image has foreign byte order");
+    if (Load32(p + 8) != kVersion || Load32(p + 16) != image.size()) {
+        throw std::runtime_error("Unsupported OMFL image");
+    }
+    CompiledConfig cfg;
+    cfg.img_.base = p;
+    cfg.img_.size = static_cast<std::uint32_t>(image.size());
+    cfg.img_.strings = Load32(p + 24);
+    cfg.img_.stringsSize = Load32(p + 28);
+    cfg.root_ = Load32(p + 20);
+    CheckRange(cfg.img_.strings, cfg.img_.stringsSize, cfg.img_.size);
+    cfg.Root();
+    return cfg;
+}
+
+/**
+ * @brief Отображает файл образа в память
+ *
+ * Разбора нет: проверяется заголовок, значения читаются прямо из
+ * отображения при обращении. Отображение принадлежит объекту.
+ * @throws std::runtime_error если файл не открылся или это не образ
+ */
+CompiledConfig CompiledConfig::Open(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open file: " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        throw std::runtime_error("Not an OMFL image: " + path);
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) throw std::runtime_error("Cannot map file: " + path);
+    std::shared_ptr<const char> mapping(static_cast<const char*>(p), [size](const char* data) {
+        munmap(const_cast<char*>(data), size);
+    });
+    CompiledConfig cfg = FromMemory(std::string_view(mapping.get(), size));
+    cfg.mapping_ = std::move(mapping);
+    return cfg;
+}
+
+CompiledSection CompiledConfig::Root() const { return CompiledSection(img_, root_); }
+
+CompiledValue CompiledConfig::Get(std::string_view key) const { return Root().Get(key); }
+
+bool CompiledConfig::Has(std::string_view key) const { return Root().Has(key); }
+
+/**
+ * @brief Проходит по пути через точку от корневой секции
+ * @return Значение или std::nullopt, если путь не существует
+ */
+static std::optional<CompiledValue> FindPath(const CompiledSection& root, std::string_view path) {
+    CompiledSection sec = root;
+    while (true) {
+        size_t dot = path.find('.');
+        std::string_view part = path.substr(0, dot);
+        size_t i = sec.Find(part);
+        if (i == sec.Size()) return std::nullopt;
+        CompiledValue v = sec.ValueAt(i);
+        if (dot == std::string_view::npos) return v;
+        if (!v.IsSection()) return std::nullopt;
+        sec = v.AsSection();
+        path.remove_prefix(dot + 1);
+    }
+}
+
+/**
+ * @brief Получает значение по пути через точку
+ * @throws std::runtime_error если путь не найден
+ */
+CompiledValue CompiledConfig::GetPath(std::string_view path) const {
+    std::optional<CompiledValue> v = FindPath(Root(), path);
+    if (!v) throw std::runtime_error("Key not found");
+    return *v;
+}
+
+bool CompiledConfig::HasPath(std::string_view path) const { return FindPath(Root(), path).has_value(); }
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "parser.h"
+
+// Скомпилированная конфигурация: бинарный образ, который читается без разбора.
+//
+// Образ не зависит от адреса загрузки: все ссылки — смещения от начала.
+// Все числа — uint32 в порядке байт машины, записавшей образ; он отмечен меткой
+// 0x01020304 в заголовке, и образ с другим порядком байт не открывается.
+//   Заголовок (32 байта): "OMFLIMG\0", версия, метка порядка байт,
+//                         размер образа, смещение корневой секции,
+//                         смещение и размер таблицы строк
+//   Секция: count, затем count записей {ключ: смещение, длина; значение: тег, a, b},
+//           отсортированных по ключу
+//   Массив: count, затем count значений {тег, a, b}
+//   Таблица строк: байты ключей и строк без повторов
+// Значение: INT/BOOL — a; FLOAT — биты float в a; STRING — смещение в таблице
+// строк (a) и длина (b); ARRAY и SECTION — смещение записи (a)
+namespace omfl {
+    class CompiledSection;
+    class CompiledArray;
+
+    // Общие данные всех представлений образа
+    struct ImageRef {
+        const char* base = nullptr;
+        std::uint32_t size = 0;
+        std::uint32_t strings = 0;
+        std::uint32_t stringsSize = 0;
+    };
+
+    class CompiledValue {
+    public:
+        bool IsInt() const;
+        bool IsFloat() const;
+        bool IsBool() const;
+        bool IsString() const;
+        bool IsArray() const;
+        bool IsSection() const;
+
+        int AsInt() const;
+        float AsFloat() const;
+        bool AsBool() const;
+        std::string_view AsString() const;
+        CompiledArray AsArray() const;
+        CompiledSection AsSection() const;
+
+    private:
+        friend class CompiledArray;
+        friend class CompiledSection;
+        CompiledValue(const ImageRef& img, std::uint32_t slot) : img_(img), slot_(slot) {}
+
+        ImageRef img_;
+        std::uint32_t slot_ = 0; // Смещение тройки {тег, a, b}
+    };
+
+    class CompiledArray {
+    public:
+        size_t size() const { return count_; }
+        bool empty() const { return count_ == 0; }
+        // Оба проверяют индекс и бросают std::out_of_range
+        CompiledValue operator[](size_t i) const;
+        CompiledValue at(size_t i) const;
+
+    private:
+        friend class CompiledValue;
+        CompiledArray(const ImageRef& img, std::uint32_t offset);
+
+        ImageRef img_;
+        std::uint32_t offset_ = 0;
+        std::uint32_t count_ = 0;
+    };
+
+    class CompiledSection {
+    public:
+        // Бинарный поиск по отсортированной таблице ключей
+        CompiledValue Get(std::string_view key) const;
+        bool Has(std::string_view key) const;
+
+        // Индекс ключа или Size(), если его нет
+        size_t Find(std::string_view key) const;
+
+        // Обход в порядке ключей; индекс вне [0, Size()) — std::out_of_range
+        size_t Size() const { return count_; }
+        std::string_view KeyAt(size_t i) const;
+        CompiledValue ValueAt(size_t i) const;
+
+    private:
+        friend class CompiledValue;
+        friend class CompiledConfig;
+        CompiledSection(const ImageRef& img, std::uint32_t offset);
+
+        ImageRef img_;
+        std::uint32_t offset_ = 0;
+        std::uint32_t count_ = 0;
+    };
+
+    class CompiledConfig {
+    public:
+        // Отобразить файл образа в память; проверяется только заголовок.
+        // Бросает std::runtime_error, если файл не открылся или это не образ
+        static CompiledConfig Open(const std::string& path);
+        // Образ в памяти без копирования: байты должны жить дольше объекта
+        static CompiledConfig FromMemory(std::string_view image);
+
+        CompiledSection Root() const;
+        CompiledValue Get(std::string_view key) const;
+        bool Has(std::string_view key) const;
+        // Доступ по пути через точку: "level1.level2.key"
+        CompiledValue GetPath(std::string_view path) const;
+        bool HasPath(std::string_view path) const;
+
+    private:
+        ImageRef img_;
+        std::uint32_t root_ = 0;
+        std::shared_ptr<const char> mapping_; // Отображение файла (Open)
+    };
+
+    // Сериализовать валидную конфигурацию в образ.
+    // Бросает std::runtime_error для невалидной конфигурации или образа больше 4 ГиБ
+    std::string CompileImage(const Config& cfg);
+    void WriteImage(const Config& cfg, const std::string& path);
+}
@@ -1,22 +1,51 @@
 #include "parser.h"
-#include <sstream>
-#include <cctype>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <new>
 #include <stdexcept>
+#include <thread>
+#include <unordered_map>
 
 namespace omfl {
 
+/**
+ * @brief Размещает пустую секцию в арене
+ *
+ * Деструктор секции не вызывается: её память и память её узлов
+ * освобождается вместе с ареной.
+ */
+static Section* NewSection(std::pmr::memory_resource* arena) {
+    void* p = arena->allocate(sizeof(Section), alignof(Section));
+    return new (p) Section(arena);
+}
+
+/**
+ * @brief Копирует байты строки в арену (с завершающим нулём)
+ */
+static std::string_view ArenaString(std::string_view v, std::pmr::memory_resource* arena) {
+    char* data = static_cast<char*>(arena->allocate(v.size() + 1, 1));
+    std::memcpy(data, v.data(), v.size());
+    data[v.size()] = '\0';
+    return std::string_view(data, v.size());
+}
+
 /**
  * @brief Проверяет соответствие типа значения
  * @throws std::runtime_error если тип не соответствует ожидаемому
  */
-#define VALUE_CHECK(type) if (type_ != Type::type) throw std::runtime_error("Bad type");
+#define VALUE_CHECK(type) if (!Resolve() || type_ != Type::type) throw std::runtime_error("Bad type");
 
-bool Value::IsInt()    const { return type_ == Type::INT; }
-bool Value::IsFloat()  const { return type_ == Type::FLOAT; }
-bool Value::IsBool()   const { return type_ == Type::BOOL; }
-bool Value::IsString() const { return type_ == Type::STRING; }
-bool Value::IsArray()  const { return type_ == Type::ARRAY; }
-bool Value::IsSection()const { return type_ == Type::SECTION; }
+bool Value::IsInt()    const { return Resolve() && type_ == Type::INT; }
+bool Value::IsFloat()  const { return Resolve() && type_ == Type::FLOAT; }
+bool Value::IsBool()   const { return Resolve() && type_ == Type::BOOL; }
+bool Value::IsString() const { return Resolve() && type_ == Type::STRING; }
+bool Value::IsArray()  const { return Resolve() && type_ == Type::ARRAY; }
+bool Value::IsSection()const { return Resolve() && type_ == Type::SECTION; }
 
 /**
  * @brief Возвращает значение как целое число
@@ -40,13 +69,13 @@ bool Value::AsBool() const  { VALUE_CHECK(BOOL);   return bool_; }
  * @brief Возвращает значение как строку
  * @throws std::runtime_error если тип не STRING
  */
-const std::string& Value::AsString() const { VALUE_CHECK(STRING); return string_; }
+std::string_view Value::AsString() const { VALUE_CHECK(STRING); return std::string_view(string_, size_); }
 
 /**
  * @brief Возвращает значение как массив
  * @throws std::runtime_error если тип не ARRAY
  */
-const std::vector<Value>& Value::AsArray() const { VALUE_CHECK(ARRAY);  return array_; }
+const std::pmr::vector<Value>& Value::AsArray() const { VALUE_CHECK(ARRAY);  return *array_; }
 
 /**
  * @brief Возвращает значение как секцию
@@ -70,19 +99,59 @@ Value Value::CreateFloat(float v)     { Value val; val.type_ = Type::FLOAT;  val
 Value Value::CreateBool(bool v)       { Value val; val.type_ = Type::BOOL;   val.bool_ = v;   return val; }
 
 /**
- * @brief Создает значение типа STRING
+ * @brief Создает значение типа STRING, копируя байты строки в арену
+ *
+ * Без арены (nullptr) строка не копируется: байты должны жить не меньше
+ * конфигурации, как отображение файла в ParseFile.
+ * @throws std::runtime_error если строка длиннее 4 ГиБ
  */
-Value Value::CreateString(const std::string& v) { Value val; val.type_ = Type::STRING; val.string_ = v; return val; }
+Value Value::CreateString(std::string_view v, std::pmr::memory_resource* arena) {
+    if (v.size() > UINT32_MAX) throw std::runtime_error("String too long");
+    Value val;
+    val.type_ = Type::STRING;
+    val.string_ = arena ? ArenaString(v, arena).data() : v.data();
+    val.size_ = static_cast<std::uint32_t>(v.size());
+    return val;
+}
 
 /**
  * @brief Создает значение типа ARRAY
+ *
+ * Элементы должны быть выделены из арены; сам вектор переносится
+ * в ту же арену, поэтому переезд элементов — только обмен указателями.
  */
-Value Value::CreateArray(const std::vector<Value>& v) { Value val; val.type_ = Type::ARRAY; val.array_ = v; return val; }
+Value Value::CreateArray(std::pmr::vector<Value> v) {
+    Value val;
+    val.type_ = Type::ARRAY;
+    std::pmr::memory_resource* arena = v.get_allocator().resource();
+    void* p = arena->allocate(sizeof(std::pmr::vector<Value>), alignof(std::pmr::vector<Value>));
+    val.array_ = new (p) std::pmr::vector<Value>(std::move(v));
+    return val;
+}
 
 /**
- * @brief Создает значение типа SECTION
+ * @brief Создает значение типа SECTION, ссылающееся на секцию из арены
  */
-Value Value::CreateSection(const Section& sec) { Value val; val.type_ = Type::SECTION; val.section_ = new Section(sec); return val; }
+Value Value::CreateSection(Section& sec) { Value val; val.type_ = Type::SECTION; val.section_ = &sec; return val; }
+
+/**
+ * @brief Текст отложенного значения и арена для его массивов
+ */
+struct Value::Lazy {
+    std::string_view text;
+    std::pmr::memory_resource* arena;
+};
+
+/**
+ * @brief Создает отложенное значение: текст будет разобран при первом обращении
+ */
+Value Value::CreateLazy(std::string_view text, std::pmr::memory_resource* arena) {
+    Value val;
+    val.type_ = Type::LAZY;
+    void* p = arena->allocate(sizeof(Lazy), alignof(Lazy));
+    val.lazy_ = new (p) Lazy{text, arena};
+    return val;
+}
 
 /**
  * @brief Получает значение по ключу
@@ -90,10 +159,10 @@ Value Value::CreateSection(const Section& sec) { Value val; val.type_ = Type::SE
  * @return Константная ссылка на значение
  * @throws std::runtime_error если ключ не найден
  */
-const Value& Section::Get(const std::string& key) const {
-    auto it = values_.find(key);
-    if (it == values_.end()) throw std::runtime_error("Key not found");
-    return it->second;
+const Value& Section::Get(std::string_view key) const {
+    const Value* v = Find(key);
+    if (!v) throw std::runtime_error("Key not found");
+    return *v;
 }
 
 /**
@@ -101,84 +170,449 @@ const Value& Section::Get(const std::string& key) const {
  * @param key Ключ для проверки
  * @return true если ключ существует, false в противном случае
  */
-bool Section::Has(const std::string& key) const {
-    return values_.find(key) != values_.end();
+bool Section::Has(std::string_view key) const {
+    return Find(key) != nullptr;
+}
+
+/**
+ * @brief Ищет значение по ключу бинарным поиском в отсортированном векторе
+ * @param key Ключ для поиска
+ * @return Указатель на значение или nullptr
+ */
+const Value* Section::Find(std::string_view key) const {
+    auto it = std::lower_bound(values_.begin(), values_.end(), key,
+                               [](const Entry& e, std::string_view k) { return e.first < k; });
+    if (it == values_.end() || it->first != key) return nullptr;
+    return &it->second;
+}
+
+/**
+ * @brief Создает пустую конфигурацию с собственной ареной
+ */
+Config::Config()
+    : arena_(std::make_unique<std::pmr::monotonic_buffer_resource>()),
+      root_(NewSection(arena_.get())) {}
+
+/**
+ * @brief Перемещает конфигурацию: корень остаётся в перенесённой арене
+ */
+Config::Config(Config&& other) noexcept
+    : valid(other.valid),
+      arena_(std::move(other.arena_)),
+      root_(other.root_),
+      source_(std::move(other.source_)),
+      chunk_arenas_(std::move(other.chunk_arenas_)) {
+    other.valid = false;
+    other.root_ = nullptr;
+}
+
+/**
+ * @brief Заменяет конфигурацию перемещённой; прежние арены освобождаются
+ */
+Config& Config::operator=(Config&& other) noexcept {
+    if (this == &other) return *this;
+    valid = other.valid;
+    arena_ = std::move(other.arena_);
+    root_ = other.root_;
+    source_ = std::move(other.source_);
+    chunk_arenas_ = std::move(other.chunk_arenas_);
+    other.valid = false;
+    other.root_ = nullptr;
+    return *this;
 }
 
 /**
  * @brief Получает значение из корневой секции по ключу
  */
-const Value& Config::Get(const std::string& key) const { return root_.Get(key); }
+const Value& Config::Get(std::string_view key) const { return root_->Get(key); }
 
 /**
  * @brief Проверяет наличие ключа в корневой секции
  */
-bool Config::Has(const std::string& key) const { return root_.Has(key); }
+bool Config::Has(std::string_view key) const { return root_->Has(key); }
+
+/**
+ * @brief Проходит по пути через точку от корневой секции
+ * @param root Корневая секция
+ * @param path Путь вида "a.b.c"
+ * @return Указатель на значение или nullptr, если путь не существует
+ */
+static const Value* FindPath(const Section& root, std::string_view path) {
+    const Section* sec = &root;
+    while (true) {
+        size_t dot = path.find('.');
+        const Value* v = sec->Find(path.substr(0, dot));
+        if (!v || dot == std::string_view::npos) return v;
+        if (!v->IsSection()) return nullptr;
+        sec = &v->AsSection();
+        path.remove_prefix(dot + 1);
+    }
+}
+
+/**
+ * @brief Получает значение по пути через точку
+ * @throws std::runtime_error если путь не найден
+ */
+const Value& Config::GetPath(std::string_view path) const {
+    const Value* v = FindPath(*root_, path);
+    if (!v) throw std::runtime_error("Key not found");
+    return *v;
+}
+
+/**
+ * @brief Проверяет наличие значения по пути через точку
+ */
+bool Config::HasPath(std::string_view path) const { return FindPath(*root_, path) != nullptr; }
+
+/**
+ * @brief Разрешает путь через точку в дескриптор
+ *
+ * После Parse секции не меняются, поэтому адрес значения в арене
+ * стабилен, в том числе при перемещении Config.
+ * @throws std::runtime_error если путь не найден
+ */
+Path Config::Compile(std::string_view path) const {
+    Path handle;
+    handle.slot_ = &GetPath(path);
+    return handle;
+}
+
+/**
+ * @brief Получает значение по заранее разрешённому пути
+ * @throws std::runtime_error если дескриптор пуст
+ */
+const Value& Config::Get(const Path& handle) const {
+    if (!handle.slot_) throw std::runtime_error("Invalid path handle");
+    return *handle.slot_;
+}
 
 /**
  * @brief Удаляет пробельные символы с начала и конца строки
  */
-static inline void trim(std::string& s) {
+static inline std::string_view trim(std::string_view s) {
     size_t a = s.find_first_not_of(" \t\r\n");
+    if (a == std::string_view::npos) return {};
     size_t b = s.find_last_not_of(" \t\r\n");
-    s = (a == std::string::npos ? "" : s.substr(a, b - a + 1));
+    return s.substr(a, b - a + 1);
 }
 
 /**
  * @brief Парсит строковое значение в объект Value
  */
-Value parseValue(const std::string& s);
+Value parseValue(std::string_view s, std::pmr::memory_resource* arena, bool borrow);
+
+/**
+ * @brief Проверяет синтаксис значения так же, как parseValue, но без выделения памяти
+ */
+static bool validValue(std::string_view s);
+
+/**
+ * @brief Разбирает отложенное значение и записывает результат на его место
+ *
+ * Строки остаются представлениями внутри текста, массивы выделяются из арены.
+ * Текст проверен validValue при загрузке, поэтому ошибка здесь не ожидается;
+ * если она всё же есть, значение остаётся отложенным.
+ * @return false, если текст значения не разбирается
+ */
+bool Value::Materialize() const {
+    Value v;
+    try {
+        v = parseValue(lazy_->text, lazy_->arena, true);
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+    switch (v.type_) {
+        case Type::INT:    int_ = v.int_; break;
+        case Type::FLOAT:  float_ = v.float_; break;
+        case Type::BOOL:   bool_ = v.bool_; break;
+        case Type::STRING: string_ = v.string_; size_ = v.size_; break;
+        case Type::ARRAY:  array_ = v.array_; break;
+        default: return false;
+    }
+    type_ = v.type_;
+    return true;
+}
+
+/**
+ * @brief Выделяет следующую строку без комментария
+ *
+ * Один проход по символам: кавычки переключают режим строки, '#' вне строки
+ * начинает комментарий, после него ищется только конец строки.
+ * @param str Весь текст конфигурации
+ * @param pos Позиция начала строки; сдвигается за её конец
+ * @return Строка без комментария (не обрезанная)
+ */
+static std::string_view nextLine(std::string_view str, size_t& pos) {
+    size_t start = pos;
+    size_t n = str.size();
+    bool inStr = false;
+    size_t i = start;
+    for (; i < n; ++i) {
+        char c = str[i];
+        if (c == '\n') break;
+        if (c == '"') inStr = !inStr;
+        if (!inStr && c == '#') {
+            const void* nl = std::memchr(str.data() + i, '\n', n - i);
+            pos = nl ? static_cast<const char*>(nl) - str.data() + 1 : n;
+            return str.substr(start, i - start);
+        }
+    }
+    pos = i < n ? i + 1 : n;
+    return str.substr(start, i - start);
+}
+
+/**
+ * @brief Ключ индекса секций на время разбора: родительская секция и имя
+ */
+struct SectionKey {
+    const Section* parent;
+    std::string_view name;
+    bool operator==(const SectionKey& o) const { return parent == o.parent && name == o.name; }
+};
+
+struct SectionKeyHash {
+    size_t operator()(const SectionKey& k) const {
+        return std::hash<std::string_view>{}(k.name) ^ (std::hash<const void*>{}(k.parent) << 1);
+    }
+};
+
+/**
+ * @brief Секция, созданная при разборе, и её место в дереве
+ *
+ * Записи о подсекциях попадают в values_ родителя только в FinishTree,
+ * поэтому до этого момента values_ содержит лишь значения ключей.
+ */
+struct SectionRecord {
+    Section* parent;
+    std::string_view name;
+    Section* sec;
+};
+
+using SectionIndex = std::pmr::unordered_map<SectionKey, Section*, SectionKeyHash>;
+
+/**
+ * @brief Замораживает секцию: сортирует записи по ключу
+ * @throws std::runtime_error при повторяющемся ключе
+ */
+static void Freeze(Section& sec) {
+    auto& v = sec.values_;
+    std::sort(v.begin(), v.end(), [](const Section::Entry& a, const Section::Entry& b) { return a.first < b.first; });
+    auto dup = std::adjacent_find(v.begin(), v.end(),
+                                  [](const Section::Entry& a, const Section::Entry& b) { return a.first == b.first; });
+    if (dup != v.end()) throw std::runtime_error("Duplicate key");
+}
+
+/**
+ * @brief Разбирает участок текста в дерево с корнем root
+ *
+ * Разбор идёт по представлениям исходного текста без копирования строк;
+ * память выделяется только из арены под итоговые ключи и значения.
+ * Записи дописываются в конец секций, повторная секция находится по
+ * индексу, новые секции добавляются в records в порядке создания
+ * (родитель всегда раньше потомка).
+ * @param root Корневая секция участка
+ * @param arena Арена для секций, ключей и значений
+ * @param str Текст участка в формате OMFL
+ * @param borrow Ключи и строки ссылаются в str вместо копирования в арену
+ * @param lazy Значения не разбираются, а после проверки синтаксиса сохраняются текстом (нужен borrow)
+ * @param records Созданные секции
+ * @throws std::runtime_error при синтаксической ошибке, в том числе в отложенном значении
+ */
+static void ParseChunk(Section& root, std::pmr::memory_resource* arena, std::string_view str,
+                       bool borrow, bool lazy, std::pmr::vector<SectionRecord>& records) {
+    auto keep = [&](std::string_view v) { return borrow ? v : ArenaString(v, arena); };
+    Section* current = &root;
+    size_t pos = 0;
+    std::pmr::monotonic_buffer_resource scratch;
+    SectionIndex index(&scratch);
+    while (pos < str.size()) {
+        std::string_view clean = trim(nextLine(str, pos));
+        if (clean.empty()) continue;
+        if (clean.front() == '[' && clean.back() == ']') {
+            std::string_view name = trim(clean.substr(1, clean.size() - 2));
+            Section* sec = &root;
+            size_t start = 0;
+            while (start < name.size()) {
+                size_t dot = name.find('.', start);
+                std::string_view part = name.substr(start, dot == std::string_view::npos ? std::string_view::npos : dot - start);
+                auto [it, inserted] = index.try_emplace(SectionKey{sec, part}, nullptr);
+                if (inserted) {
+                    it->second = NewSection(arena);
+                    records.push_back({sec, keep(part), it->second});
+                }
+                sec = it->second;
+                if (dot == std::string_view::npos) break;
+                start = dot + 1;
+            }
+            current = sec;
+            continue;
+        }
+        size_t eq = clean.find('=');
+        if (eq == std::string_view::npos) throw std::runtime_error("Invalid line");
+        std::string_view key = trim(clean.substr(0, eq));
+        std::string_view val = trim(clean.substr(eq + 1));
+        if (key.empty() || val.empty()) throw std::runtime_error("Empty key or value");
+        if (lazy && !validValue(val)) throw std::runtime_error("Bad value");
+        current->values_.emplace_back(keep(key), lazy ? Value::CreateLazy(val, arena) : parseValue(val, arena, borrow));
+    }
+}
+
+/**
+ * @brief Достраивает дерево: добавляет подсекции в родителей и замораживает секции
+ *
+ * Ключ, совпавший с именем секции, обнаруживается здесь как повтор.
+ * @throws std::runtime_error при повторяющемся ключе
+ */
+static void FinishTree(Section& root, const std::pmr::vector<SectionRecord>& records) {
+    for (const SectionRecord& r : records) r.parent->values_.emplace_back(r.name, Value::CreateSection(*r.sec));
+    Freeze(root);
+    for (const SectionRecord& r : records) Freeze(*r.sec);
+}
+
+/**
+ * @brief Разбирает текст конфигурации в пустой Config
+ * @param cfg Пустая конфигурация для заполнения
+ * @param str Строка с конфигурацией в формате OMFL
+ * @param borrow Ключи и строки ссылаются в str вместо копирования в арену
+ * @param lazy Значения не разбираются, а сохраняются текстом (нужен borrow)
+ */
+static void ParseInto(Config& cfg, std::string_view str, bool borrow, bool lazy) {
+    std::pmr::monotonic_buffer_resource scratch;
+    std::pmr::vector<SectionRecord> records(&scratch);
+    try {
+        ParseChunk(*cfg.root_, cfg.arena_.get(), str, borrow, lazy, records);
+        FinishTree(*cfg.root_, records);
+        cfg.valid = true;
+    } catch (...) {
+        cfg.valid = false;
+    }
+}
 
 /**
  * @brief Основная функция парсинга конфигурации
+ *
+ * В ленивом режиме текст целиком копируется в арену одним блоком,
+ * чтобы отложенные значения могли ссылаться в него.
  * @param str Строка с конфигурацией в формате OMFL
+ * @param mode Сразу разбирать значения или откладывать до обращения
  * @return Объект Config с распарсенными данными
  */
-Config Parse(const std::string& str) {
+Config Parse(std::string_view str, ParseMode mode) {
     Config cfg;
-    Section* current = &cfg.root_;
-    std::istringstream in(str);
-    std::string line;
-    try {
-        while (std::getline(in, line)) {
-            bool inStr = false;
-            std::string clean;
-            for (char c : line) {
-                if (c == '"') inStr = !inStr;
-                if (!inStr && c == '#') break;
-                clean += c;
-            }
-            trim(clean);
-            if (clean.empty()) continue;
-            if (clean.front() == '[' && clean.back() == ']') {
-                std::string name = clean.substr(1, clean.size() - 2);
-                trim(name);
-                Section* sec = &cfg.root_;
-                size_t start = 0;
-                while (start < name.size()) {
-                    size_t dot = name.find('.', start);
-                    std::string part = name.substr(start, dot == std::string::npos ? std::string::npos : dot - start);
-                    if (!sec->Has(part)) {
-                        Section newSec;
-                        sec->values_[part] = Value::CreateSection(newSec);
-                    }
-                    sec = &const_cast<Section&>(sec->values_[part].AsSection());
-                    if (dot == std::string::npos) break;
-                    start = dot + 1;
-                }
-                current = sec;
-                continue;
+    if (mode == ParseMode::Lazy) {
+        ParseInto(cfg, ArenaString(str, cfg.arena_.get()), true, true);
+    } else {
+        ParseInto(cfg, str, false, false);
+    }
+    return cfg;
+}
+
+/**
+ * @brief Минимальный размер участка параллельного разбора, меньшие тексты разбираются в одном потоке
+ */
+static constexpr size_t kMinChunkSize = 64 * 1024;
+
+/**
+ * @brief Находит начало ближайшей строки-заголовка секции не раньше pos
+ * @return Позиция начала строки или str.size(), если заголовков дальше нет
+ */
+static size_t NextHeader(std::string_view str, size_t pos) {
+    if (pos > 0) {
+        size_t nl = str.find('\n', pos - 1);
+        if (nl == std::string_view::npos) return str.size();
+        pos = nl + 1;
+    }
+    while (pos < str.size()) {
+        size_t next = pos;
+        std::string_view line = trim(nextLine(str, next));
+        if (!line.empty() && line.front() == '[' && line.back() == ']') return pos;
+        pos = next;
+    }
+    return str.size();
+}
+
+/**
+ * @brief Параллельно парсит большую конфигурацию
+ *
+ * Текст делится на участки по строкам-заголовкам секций, поэтому каждый
+ * участок, кроме первого, начинается с заголовка и разбирается независимо
+ * в собственной арене. Затем деревья участков сливаются в одном потоке:
+ * одноимённые секции объединяются, а повторы ключей, как и в Parse,
+ * обнаруживаются при заморозке секций.
+ * @param str Строка с конфигурацией в формате OMFL
+ * @param threads Число потоков, 0 — std::thread::hardware_concurrency()
+ * @return Объект Config с распарсенными данными
+ */
+Config ParseParallel(std::string_view str, unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t parts = std::min<size_t>(threads, str.size() / kMinChunkSize);
+    std::vector<size_t> bounds{0};
+    for (size_t k = 1; k < parts; ++k) {
+        size_t b = NextHeader(str, std::max(bounds.back() + 1, str.size() / parts * k));
+        if (b >= str.size()) break;
+        bounds.push_back(b);
+    }
+    bounds.push_back(str.size());
+    if (bounds.size() <= 2) return Parse(str);
+
+    struct Chunk {
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
+        Section* root = nullptr;
+        std::pmr::vector<SectionRecord> records;
+        bool ok = false;
+    };
+    Config cfg;
+    std::vector<Chunk> chunks(bounds.size() - 1);
+    for (size_t k = 1; k < chunks.size(); ++k) {
+        chunks[k].arena = std::make_unique<std::pmr::monotonic_buffer_resource>();
+        chunks[k].root = NewSection(chunks[k].arena.get());
+    }
+    auto run = [&](size_t k) {
+        Section& root = k == 0 ? *cfg.root_ : *chunks[k].root;
+        std::pmr::memory_resource* arena = k == 0 ? cfg.arena_.get() : chunks[k].arena.get();
+        try {
+            ParseChunk(root, arena, str.substr(bounds[k], bounds[k + 1] - bounds[k]), false, false, chunks[k].records);
+            chunks[k].ok = true;
+        } catch (...) {
+            chunks[k].ok = false;
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t k = 1; k < chunks.size(); ++k) workers.emplace_back(run, k);
+    run(0);
+    for (std::thread& t : workers) t.join();
+
+    for (Chunk& c : chunks) {
+        if (!c.ok) return cfg;
+    }
+
+    // Слияние: секции участков отображаются на секции итогового дерева
+    std::pmr::monotonic_buffer_resource scratch;
+    SectionIndex index(&scratch);
+    std::pmr::vector<SectionRecord> records(chunks[0].records, &scratch);
+    for (const SectionRecord& r : records) index.emplace(SectionKey{r.parent, r.name}, r.sec);
+    for (size_t k = 1; k < chunks.size(); ++k) {
+        Chunk& c = chunks[k];
+        std::pmr::unordered_map<const Section*, Section*> target(&scratch);
+        target[c.root] = cfg.root_;
+        auto& rootValues = cfg.root_->values_;
+        rootValues.insert(rootValues.end(), c.root->values_.begin(), c.root->values_.end());
+        for (const SectionRecord& r : c.records) {
+            Section* parent = target.at(r.parent);
+            auto [it, inserted] = index.try_emplace(SectionKey{parent, r.name}, r.sec);
+            if (inserted) {
+                records.push_back({parent, r.name, r.sec});
+                target[r.sec] = r.sec;
+            } else {
+                target[r.sec] = it->second;
+                auto& dst = it->second->values_;
+                dst.insert(dst.end(), r.sec->values_.begin(), r.sec->values_.end());
             }
-            size_t eq = clean.find('=');
-            if (eq == std::string::npos) throw std::runtime_error("Invalid line");
-            std::string key = clean.substr(0, eq);
-            std::string val = clean.substr(eq + 1);
-            trim(key); trim(val);
-            if (key.empty() || val.empty()) throw std::runtime_error("Empty key or value");
-            Value v = parseValue(val);
-            if (current->Has(key)) throw std::runtime_error("Duplicate key");
-            current->values_[key] = std::move(v);
         }
+        cfg.chunk_arenas_.push_back(std::move(c.arena));
+    }
+    try {
+        FinishTree(*cfg.root_, records);
         cfg.valid = true;
     } catch (...) {
         cfg.valid = false;
@@ -186,50 +620,145 @@ Config Parse(const std::string& str) {
     return cfg;
 }
 
+/**
+ * @brief Парсит файл, отображённый в память
+ *
+ * Файл отображается только для чтения и разбирается прямо из отображения,
+ * без промежуточных копий текста; ключи и строковые значения остаются
+ * представлениями внутри него. Отображение принадлежит Config.
+ * @param path Путь к файлу
+ * @param mode Сразу разбирать значения или откладывать до обращения
+ * @return Объект Config с распарсенными данными
+ * @throws std::runtime_error если файл не удалось открыть или отобразить
+ */
+Config ParseFile(const std::string& path, ParseMode mode) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open file: " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot stat file: " + path);
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    Config cfg;
+    if (size == 0) {
+        close(fd);
+        ParseInto(cfg, {}, false, false);
+        return cfg;
+    }
+    void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) throw std::runtime_error("Cannot map file: " + path);
+    madvise(p, size, MADV_SEQUENTIAL);
+    cfg.source_ = std::shared_ptr<const char>(static_cast<const char*>(p), [size](const char* data) {
+        munmap(const_cast<char*>(data), size);
+    });
+    ParseInto(cfg, std::string_view(cfg.source_.get(), size), true, mode == ParseMode::Lazy);
+    return cfg;
+}
+
+/**
+ * @brief Разбирает числовой префикс как std::stoi/std::stof: знак, число, остаток строки игнорируется
+ * @return false, если числа нет или оно вне диапазона T
+ */
+template <class T>
+static bool numberPrefix(std::string_view s, T& v) {
+    if (s.size() > 1 && s[0] == '+' && s[1] != '+' && s[1] != '-') s.remove_prefix(1);
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+    return ec == std::errc();
+}
+
+/**
+ * @brief Разбирает целое число как std::stoi
+ * @throws std::runtime_error если цифр нет или число вне диапазона int
+ */
+static int parseIntPrefix(std::string_view s) {
+    int v = 0;
+    if (!numberPrefix(s, v)) throw std::runtime_error("Bad int");
+    return v;
+}
+
+/**
+ * @brief Разбирает вещественное число как std::stof
+ * @throws std::runtime_error если числа нет или оно вне диапазона float
+ */
+static float parseFloatPrefix(std::string_view s) {
+    float v = 0;
+    if (!numberPrefix(s, v)) throw std::runtime_error("Bad float");
+    return v;
+}
+
 /**
  * @brief Парсит строку в соответствующее значение Value
- * @param s Строка для парсинга
+ * @param s Строка для парсинга (представление внутри исходного текста)
+ * @param arena Арена конфигурации для строк и массивов
+ * @param borrow Строки ссылаются в исходный текст без копирования
  * @return Объект Value с распарсенным значением
  * @throws std::runtime_error при ошибке парсинга
  */
-Value parseValue(const std::string& s) {
-    if (s.front() == '"' && s.back() == '"') {
-        return Value::CreateString(s.substr(1, s.size() - 2));
+Value parseValue(std::string_view s, std::pmr::memory_resource* arena, bool borrow) {
+    if (s.size() > 1 && s.front() == '"' && s.back() == '"') {
+        return Value::CreateString(s.substr(1, s.size() - 2), borrow ? nullptr : arena);
     }
     if (s == "true" || s == "false") {
         return Value::CreateBool(s == "true");
     }
-    if (s.front() == '[' && s.back() == ']') {
-        std::vector<Value> arr;
-        std::string inner = s.substr(1, s.size() - 2);
+    if (s.size() > 1 && s.front() == '[' && s.back() == ']') {
+        std::pmr::vector<Value> arr(arena);
+        std::string_view inner = s.substr(1, s.size() - 2);
         int depth = 0;
         size_t start = 0;
-        for (size_t i = 0; i <= inner.size(); ++i) {
-            if (i < inner.size()) {
-                if (inner[i] == '[') depth++;
-                if (inner[i] == ']') depth--;
-                if (inner[i] == ',' && depth == 0) {
-                    std::string item = inner.substr(start, i - start);
-                    trim(item);
-                    arr.push_back(parseValue(item));
-                    start = i + 1;
-                }
-                continue;
+        for (size_t i = 0; i < inner.size(); ++i) {
+            if (inner[i] == '[') depth++;
+            if (inner[i] == ']') depth--;
+            if (inner[i] == ',' && depth == 0) {
+                arr.push_back(parseValue(trim(inner.substr(start, i - start)), arena, borrow));
+                start = i + 1;
             }
-            std::string item = inner.substr(start);
-            trim(item);
-            if (!item.empty()) arr.push_back(parseValue(item));
         }
-        return Value::CreateArray(arr);
+        std::string_view item = trim(inner.substr(start));
+        if (!item.empty()) arr.push_back(parseValue(item, arena, borrow));
+        return Value::CreateArray(std::move(arr));
     }
-    bool hasDot = s.find('.') != std::string::npos;
+    bool hasDot = s.find('.') != std::string_view::npos;
     if (!hasDot) {
-        int v = std::stoi(s);
-        return Value::CreateInt(v);
+        return Value::CreateInt(parseIntPrefix(s));
     } else {
-        float v = std::stof(s);
-        return Value::CreateFloat(v);
+        return Value::CreateFloat(parseFloatPrefix(s));
+    }
+}
+
+/**
+ * @brief Проверяет значение для ленивого режима: те же правила, что в parseValue
+ *
+ * Один проход по тексту без арены; массивы проверяются поэлементно.
+ * @param s Текст значения
+ * @return true, если parseValue разберёт текст без ошибки
+ */
+static bool validValue(std::string_view s) {
+    if (s.size() > 1 && s.front() == '"' && s.back() == '"') return s.size() - 2 <= UINT32_MAX;
+    if (s == "true" || s == "false") return true;
+    if (s.size() > 1 && s.front() == '[' && s.back() == ']') {
+        std::string_view inner = s.substr(1, s.size() - 2);
+        int depth = 0;
+        size_t start = 0;
+        for (size_t i = 0; i < inner.size(); ++i) {
+            if (inner[i] == '[') depth++;
+            if (inner[i] == ']') depth--;
+            if (inner[i] == ',' && depth == 0) {
+                if (!validValue(trim(inner.substr(start, i - start)))) return false;
+                start = i + 1;
+            }
+        }
+        std::string_view item = trim(inner.substr(start));
+        return item.empty() || validValue(item);
+    }
+    if (s.find('.') == std::string_view::npos) {
+        int v = 0;
+        return numberPrefix(s, v);
     }
+    float v = 0;
+    return numberPrefix(s, v);
 }
 
 }
@@ -1,7 +1,11 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <map>
+#include <utility>
+#include <memory>
+#include <memory_resource>
 
 namespace omfl {
     class Section;
@@ -20,50 +24,126 @@ namespace omfl {
         int AsInt() const;
         float AsFloat() const;
         bool AsBool() const;
-        const std::string& AsString() const;
-        const std::vector<Value>& AsArray() const;
+        std::string_view AsString() const;
+        const std::pmr::vector<Value>& AsArray() const;
         const Section& AsSection() const;
 
-        // Констукторы для внутренного использования
+        // Констукторы для внутренного использования.
+        // Строки, массивы и секции живут в арене Config, Value их не владеет.
+        // CreateString без арены не копирует байты (строка из отображения ParseFile)
         static Value CreateInt(int v);
         static Value CreateFloat(float v);
         static Value CreateBool(bool v);
-        static Value CreateString(const std::string& v);
-        static Value CreateArray(const std::vector<Value>& v);
-        static Value CreateSection(const Section& sec);
+        static Value CreateString(std::string_view v, std::pmr::memory_resource* arena);
+        static Value CreateArray(std::pmr::vector<Value> v);
+        static Value CreateSection(Section& sec);
+        // Неразобранный текст значения (ParseMode::Lazy); text должен жить не меньше арены
+        static Value CreateLazy(std::string_view text, std::pmr::memory_resource* arena);
 
     private:
-        enum class Type { INT, FLOAT, BOOL, STRING, ARRAY, SECTION, NONE } type_{Type::NONE};
-        int int_{};
-        float float_{};
-        bool bool_{};
-        std::string string_;
-        std::vector<Value> array_;
-        Section* section_{}; // Указатель на собственную секцию в памяти
+        struct Lazy;
+
+        // Разбор отложенного значения при первом обращении (на месте); false, если текст не разобрался
+        bool Resolve() const { return type_ != Type::LAZY || Materialize(); }
+        bool Materialize() const;
+
+        // Тег, длина строки и одно 8-байтовое поле: всего 16 байт.
+        // mutable — отложенное значение заменяется разобранным в константных методах
+        enum class Type : std::uint8_t { INT, FLOAT, BOOL, STRING, ARRAY, SECTION, LAZY, NONE };
+        mutable Type type_{Type::NONE};
+        mutable std::uint32_t size_{};                     // Длина строки (только для STRING)
+        union {
+            mutable int int_;
+            mutable float float_;
+            mutable bool bool_;
+            mutable const char* string_{};                 // Байты строки в арене
+            mutable const std::pmr::vector<Value>* array_; // Массив в арене
+            Section* section_;                             // Секция в арене
+            const Lazy* lazy_;                             // Текст отложенного значения
+        };
     };
 
+    static_assert(sizeof(Value) <= 16, "omfl::Value must stay a 16-byte tagged union");
+
     class Section {
     public:
+        using Entry = std::pair<std::string_view, Value>;
+
+        explicit Section(std::pmr::memory_resource* arena) : values_(arena) {}
+
         // Получить значения или подсекцию по ключу
-        const Value& Get(const std::string& key) const;
-        bool Has(const std::string& key) const;
+        const Value& Get(std::string_view key) const;
+        bool Has(std::string_view key) const;
+        // Поиск без исключения: nullptr, если ключа нет
+        const Value* Find(std::string_view key) const;
+
+        // Делаем внутренее хранилище доступным для логики парсера.
+        // После Parse вектор отсортирован по ключу (бинарный поиск),
+        // ключи лежат в арене Config
+        std::pmr::vector<Entry> values_;
+    };
+
+    // Заранее разрешённый путь "a.b.c" (см. Config::Compile).
+    // Указывает прямо на значение в арене и действителен, пока жива конфигурация
+    class Path {
+    public:
+        bool IsValid() const { return slot_ != nullptr; }
 
-        // Делаем внутренее хранилище доступным для логики парсера
-        std::map<std::string, Value> values_;
+    private:
+        friend class Config;
+        const Value* slot_ = nullptr;
     };
 
+    // Все секции, значения и строки конфигурации лежат в одной монотонной арене.
+    // Деструкторы узлов не вызываются: уничтожение Config освобождает арену целиком.
+    // Перемещение передаёт арену вместе с корнем; перемещённый Config невалиден
+    // и годен только для присваивания и уничтожения
     class Config {
     public:
+        Config();
+        Config(Config&& other) noexcept;
+        Config& operator=(Config&& other) noexcept;
+
         bool valid = false;
         bool IsValid() const { return valid; }
 
-        const Value& Get(const std::string& key) const;
-        bool Has(const std::string& key) const;
+        const Value& Get(std::string_view key) const;
+        bool Has(std::string_view key) const;
+
+        // Доступ по пути через точку: "level1.level2.key"
+        const Value& GetPath(std::string_view path) const;
+        bool HasPath(std::string_view path) const;
 
-        // Доступность парсера относительно корневой секции root
-        Section root_;
+        // Разрешить путь один раз; Get(handle) затем работает за O(1)
+        Path Compile(std::string_view path) const;
+        const Value& Get(const Path& handle) const;
+
+        // Арена и корневая секция в ней доступны парсеру
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_;
+        Section* root_;
+        // Отображение файла (ParseFile): ключи и строки ссылаются прямо в него
+        std::shared_ptr<const char> source_;
+        // Арены участков ParseParallel, кроме первого
+        std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource>> chunk_arenas_;
     };
 
+    // Eager — все значения разбираются сразу.
+    // Lazy — при загрузке строится индекс секций и ключей, а значение лишь проверяется
+    // на синтаксис без выделения памяти и разбирается при первом Is*/As*.
+    // IsValid() ложен для тех же текстов, что и в Eager; Is*() не бросают исключений.
+    // Первое обращение изменяет значение: одновременное чтение одного Config
+    // из нескольких потоков в этом режиме требует внешней синхронизации
+    enum class ParseMode { Eager, Lazy };
+
     // Парсинг omfl конфигурации из строки
-    Config Parse(const std::string& str);
+    Config Parse(std::string_view str, ParseMode mode = ParseMode::Eager);
+
+    // Парсинг файла, отображённого в память; отображение живёт вместе с Config.
+    // Бросает std::runtime_error, если файл не удалось открыть
+    Config ParseFile(const std::string& path, ParseMode mode = ParseMode::Eager);
+
+    // Параллельный разбор большого текста: участки между заголовками секций
+    // разбираются на threads потоках (0 — по числу ядер) и сливаются в одно дерево.
+    // Результат и правила ошибок те же, что у Parse
+    Config ParseParallel(std::string_view str, unsigned threads = 0);
 }
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include "../lib/parser.h"
+#include "../lib/compiled.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 
 using namespace omfl;
@@ -153,7 +157,7 @@ TEST(ParserTestSuite, SectionTest) {
 
     Config root = Parse(data);
     ASSERT_TRUE(root.IsValid());
-    const auto& sec = root.root_.Get("section1").AsSection();
+    const auto& sec = root.root_->Get("section1").AsSection();
     EXPECT_EQ(sec.Get("key1").AsInt(), 1);
     EXPECT_EQ(sec.Get("key2").AsBool(), true);
     EXPECT_EQ(sec.Get("key3").AsString(), "value");
@@ -171,7 +175,7 @@ TEST(ParserTestSuite, MultiSectionTest) {
 
     Config root = Parse(data);
     ASSERT_TRUE(root.IsValid());
-    const auto& lvl1 = root.root_.Get("level1").AsSection();
+    const auto& lvl1 = root.root_->Get("level1").AsSection();
     EXPECT_EQ(lvl1.Get("key1").AsInt(), 1);
     const auto& l2a = lvl1.Get("level2-1").AsSection(); EXPECT_EQ(l2a.Get("key2").AsInt(), 2);
     const auto& l2b = lvl1.Get("level2-2").AsSection(); EXPECT_EQ(l2b.Get("key3").AsInt(), 3);
@@ -184,8 +188,264 @@ TEST(ParserTestSuite, GetSectionTest) {
 
     Config root = Parse(data);
     ASSERT_TRUE(root.IsValid());
-    const auto& lvl3 = root.root_.Get("level1").AsSection()
+    const auto& lvl3 = root.root_->Get("level1").AsSection()
                                 .Get("level2").AsSection()
                                 .Get("level3").AsSection();
     EXPECT_EQ(lvl3.Get("key1").AsInt(), 1);
 }
+
+TEST(ParserTestSuite, CrlfAndHashInStringTest) {
+    std::string data = "key1 = \"a # b\" # comment\r\n[sec]\r\nkey2 = [1, 2] # [3]\r\nkey3 = -7\r\n";
+
+    Config root = Parse(data);
+    ASSERT_TRUE(root.IsValid());
+    EXPECT_EQ(root.root_->Get("key1").AsString(), "a # b");
+    const auto& sec = root.root_->Get("sec").AsSection();
+    EXPECT_EQ(sec.Get("key2").AsArray().size(), 2);
+    EXPECT_EQ(sec.Get("key3").AsInt(), -7);
+}
+
+TEST(ParserTestSuite, MovedConfigKeepsArenaTest) {
+    std::string data = R"(
+        [a.b]
+        s = "text"
+        arr = [1, [2, 3]])";
+
+    Config cfg = Parse(data);
+    Value b = cfg.Get("a").AsSection().Get("b");
+    Config moved = std::move(cfg);
+    ASSERT_TRUE(moved.IsValid());
+    EXPECT_EQ(b.AsSection().Get("s").AsString(), "text");
+    EXPECT_EQ(moved.root_->Get("a").AsSection().Get("b").AsSection().Get("arr").AsArray().at(1).AsArray().at(1).AsInt(), 3);
+}
+
+TEST(ParserTestSuite, MoveAssignedConfigTest) {
+    Config cfg = Parse("a = 1\n[s]\nb = \"x\"");
+    Config other = Parse("c = 2");
+    Value s = cfg.Get("s");
+    other = std::move(cfg);
+    ASSERT_TRUE(other.IsValid());
+    ASSERT_FALSE(cfg.IsValid());
+    EXPECT_FALSE(other.Has("c"));
+    EXPECT_EQ(other.Get("a").AsInt(), 1);
+    EXPECT_EQ(s.AsSection().Get("b").AsString(), "x");
+
+    // Перемещённый Config можно снова заполнить присваиванием
+    cfg = Parse("d = 3");
+    EXPECT_EQ(cfg.Get("d").AsInt(), 3);
+    other = std::move(other);
+    EXPECT_EQ(other.Get("a").AsInt(), 1);
+}
+
+TEST(ParserTestSuite, CompactValueTest) {
+    std::string data = R"(
+        empty = ""
+        flag = false
+        mixed = ["ab", 0, 1.5, true])";
+
+    Config root = Parse(data);
+    ASSERT_TRUE(root.IsValid());
+    EXPECT_EQ(sizeof(Value), 16);
+    EXPECT_TRUE(root.Get("empty").AsString().empty());
+    EXPECT_FALSE(root.Get("flag").AsBool());
+    EXPECT_THROW(root.Get("flag").AsInt(), std::runtime_error);
+    const auto& arr = root.Get("mixed").AsArray();
+    EXPECT_EQ(arr.at(0).AsString(), "ab");
+    EXPECT_EQ(arr.at(1).AsInt(), 0);
+    EXPECT_FLOAT_EQ(arr.at(2).AsFloat(), 1.5f);
+    EXPECT_TRUE(arr.at(3).AsBool());
+}
+
+TEST(ParserTestSuite, SortedSectionStorageTest) {
+    std::string data = R"(
+        [sec]
+        zeta = 1
+        alpha = 2
+        [other]
+        x = 0
+        [sec]
+        mid = 3)";
+
+    Config root = Parse(data);
+    ASSERT_TRUE(root.IsValid());
+    std::vector<std::string> keys;
+    for (const auto& [key, val] : root.Get("sec").AsSection().values_) keys.emplace_back(key);
+    EXPECT_EQ(keys, (std::vector<std::string>{"alpha", "mid", "zeta"}));
+
+    EXPECT_FALSE(Parse("[sec]\nk = 1\n[sec]\nk = 2").IsValid());
+    EXPECT_FALSE(Parse("a = 1\n[a]\nb = 2").IsValid());
+}
+
+TEST(ParserTestSuite, PathLookupTest) {
+    std::string data = R"(
+        top = 0
+        [level1.level2]
+        key = 42
+        [level1]
+        name = "l1")";
+
+    Config root = Parse(data);
+    ASSERT_TRUE(root.IsValid());
+    EXPECT_EQ(root.GetPath("level1.level2.key").AsInt(), 42);
+    EXPECT_EQ(root.GetPath("top").AsInt(), 0);
+    EXPECT_TRUE(root.GetPath("level1.level2").IsSection());
+    EXPECT_FALSE(root.HasPath("level1.missing"));
+    EXPECT_FALSE(root.HasPath("top.key"));
+    EXPECT_THROW(root.GetPath("level1.level2.key.x"), std::runtime_error);
+    EXPECT_THROW(root.Get("level1.level2"), std::runtime_error);
+
+    Path key = root.Compile("level1.level2.key");
+    Path name = root.Compile("level1.name");
+    Config moved = std::move(root);
+    EXPECT_EQ(moved.Get(key).AsInt(), 42);
+    EXPECT_EQ(moved.Get(name).AsString(), "l1");
+    EXPECT_THROW(moved.Compile("level1.nope"), std::runtime_error);
+    EXPECT_THROW(moved.Get(Path{}), std::runtime_error);
+}
+
+TEST(ParserTestSuite, ParseFileTest) {
+    std::string path = (std::filesystem::temp_directory_path() / "omfl_parse_file_test.omfl").string();
+    {
+        std::ofstream out(path);
+        out << "title = \"mapped\"\n[server]\nports = [80, 443]\n";
+    }
+
+    Config cfg = ParseFile(path);
+    std::filesystem::remove(path);
+    ASSERT_TRUE(cfg.IsValid());
+    std::string_view title = cfg.Get("title").AsString();
+    EXPECT_EQ(title, "mapped");
+    ASSERT_NE(cfg.source_, nullptr);
+    EXPECT_GE(title.data(), cfg.source_.get());
+    EXPECT_EQ(cfg.GetPath("server.ports").AsArray().at(1).AsInt(), 443);
+
+    EXPECT_THROW(ParseFile(path), std::runtime_error);
+}
+
+TEST(ParserTestSuite, LazyParseTest) {
+    std::string data = R"(
+        name = "lazy"
+        num = 7
+        [sec]
+        arr = [1, [2.5, "x"], true])";
+
+    Config root = Parse(data, ParseMode::Lazy);
+    data.assign(data.size(), ' ');
+    ASSERT_TRUE(root.IsValid());
+    EXPECT_EQ(root.Get("name").AsString(), "lazy");
+    EXPECT_TRUE(root.Get("name").IsString());
+    EXPECT_FALSE(root.Get("num").IsString());
+    EXPECT_TRUE(root.Get("num").IsInt());
+    const auto& arr = root.GetPath("sec.arr").AsArray();
+    EXPECT_EQ(arr.at(0).AsInt(), 1);
+    EXPECT_FLOAT_EQ(arr.at(1).AsArray().at(0).AsFloat(), 2.5f);
+    EXPECT_EQ(arr.at(1).AsArray().at(1).AsString(), "x");
+    EXPECT_THROW(root.Get("name").AsInt(), std::runtime_error);
+
+    EXPECT_FALSE(Parse("a = 1\na = 2", ParseMode::Lazy).IsValid());
+    EXPECT_FALSE(Parse("key = ", ParseMode::Lazy).IsValid());
+}
+
+TEST(ParserTestSuite, LazyRejectsBadValueTest) {
+    // Синтаксис значений проверяется при загрузке: ленивый режим отвергает те же тексты, что и обычный
+    for (const char* text : {"bad = abcd", "x = [1, abc]", "x = [[1, 2], [3, .]]", "x = 99999999999", "[s]\nx = -"}) {
+        EXPECT_FALSE(Parse(text).IsValid()) << text;
+        EXPECT_FALSE(Parse(text, ParseMode::Lazy).IsValid()) << text;
+    }
+    for (const char* text : {"x = +5", "x = 1.5e3", "x = []", "x = [\"ab\", [true], -2]", "x = 12abc"}) {
+        EXPECT_TRUE(Parse(text).IsValid()) << text;
+        EXPECT_TRUE(Parse(text, ParseMode::Lazy).IsValid()) << text;
+    }
+}
+
+static void DumpSection(const Section& sec, const std::string& prefix, std::ostringstream& out) {
+    for (const auto& [key, val] : sec.values_) {
+        if (val.IsSection()) {
+            DumpSection(val.AsSection(), prefix + std::string(key) + ".", out);
+        } else if (val.IsInt()) {
+            out << prefix << key << "=" << val.AsInt() << "\n";
+        } else if (val.IsString()) {
+            out << prefix << key << "=" << val.AsString() << "\n";
+        } else if (val.IsArray()) {
+            out << prefix << key << "=[" << val.AsArray().size() << "]\n";
+        }
+    }
+}
+
+TEST(ParserTestSuite, ParallelParseTest) {
+    std::ostringstream data;
+    data << "title = \"inventory\"\n";
+    for (int i = 0; i < 20000; ++i) {
+        data << "[group" << i % 50 << ".item" << i << "]\n"
+             << "id = " << i << "\nname = \"n" << i << "\" # comment\narr = [1, [2, 3]]\n"
+             << "[group" << i % 50 << "]\ncount" << i << " = " << i << "\n";
+    }
+    std::string text = data.str();
+
+    Config seq = Parse(text);
+    Config par = ParseParallel(text, 4);
+    ASSERT_TRUE(seq.IsValid());
+    ASSERT_TRUE(par.IsValid());
+    std::ostringstream a, b;
+    DumpSection(*seq.root_, "", a);
+    DumpSection(*par.root_, "", b);
+    EXPECT_EQ(a.str(), b.str());
+    EXPECT_EQ(par.GetPath("group7.item19957.id").AsInt(), 19957);
+
+    EXPECT_FALSE(ParseParallel(text + "[group0.item0]\nid = 1\n", 4).IsValid());
+    EXPECT_FALSE(ParseParallel(text + "[group3]\nitem3 = 1\n", 4).IsValid());
+    EXPECT_FALSE(ParseParallel(text + "[group3]\nbroken\n", 4).IsValid());
+}
+
+TEST(ParserTestSuite, CompiledImageTest) {
+    std::string data = R"(
+        title = "omfl"
+        pi = 3.5
+        [server.http]
+        port = 8080
+        enabled = true
+        hosts = ["a", "b", ["omfl", -1]])";
+
+    Config cfg = Parse(data);
+    ASSERT_TRUE(cfg.IsValid());
+    std::string image = CompileImage(cfg);
+
+    CompiledConfig img = CompiledConfig::FromMemory(image);
+    EXPECT_EQ(img.Get("title").AsString(), "omfl");
+    EXPECT_FLOAT_EQ(img.Get("pi").AsFloat(), 3.5f);
+    EXPECT_EQ(img.GetPath("server.http.port").AsInt(), 8080);
+    EXPECT_TRUE(img.GetPath("server.http.enabled").AsBool());
+    CompiledArray hosts = img.GetPath("server.http.hosts").AsArray();
+    ASSERT_EQ(hosts.size(), 3);
+    EXPECT_EQ(hosts.at(1).AsString(), "b");
+    EXPECT_EQ(hosts.at(2).AsArray().at(0).AsString(), "omfl");
+    EXPECT_EQ(hosts.at(2).AsArray().at(1).AsInt(), -1);
+    EXPECT_THROW(hosts.at(3), std::out_of_range);
+    EXPECT_THROW(hosts[3], std::out_of_range);
+    EXPECT_FALSE(img.Has("server.http"));
+    EXPECT_FALSE(img.HasPath("server.http.missing"));
+    EXPECT_THROW(img.Get("title").AsInt(), std::runtime_error);
+
+    CompiledSection http = img.GetPath("server.http").AsSection();
+    ASSERT_EQ(http.Size(), 3);
+    EXPECT_EQ(http.KeyAt(0), "enabled");
+    EXPECT_EQ(http.KeyAt(2), "port");
+    EXPECT_THROW(http.KeyAt(3), std::out_of_range);
+    EXPECT_THROW(http.ValueAt(3), std::out_of_range);
+
+    std::string path = (std::filesystem::temp_directory_path() / "omfl_compiled_test.omflc").string();
+    WriteImage(cfg, path);
+    CompiledConfig mapped = CompiledConfig::Open(path);
+    std::filesystem::remove(path);
+    EXPECT_EQ(mapped.GetPath("server.http.port").AsInt(), 8080);
+
+    std::string broken = image;
+    broken[0] = 'X';
+    EXPECT_THROW(CompiledConfig::FromMemory(broken), std::runtime_error);
+    EXPECT_THROW(CompiledConfig::FromMemory(std::string_view(image).substr(0, image.size() - 1)), std::runtime_error);
+    // Образ с другим порядком байт: метка в заголовке перевёрнута
+    std::string swapped = image;
+    std::reverse(swapped.begin() + 12, swapped.begin() + 16);
+    EXPECT_THROW(CompiledConfig::FromMemory(swapped), std::runtime_error);
+    EXPECT_THROW(CompileImage(Parse("key = ")), std::runtime_error);
+}